@@ -0,0 +1,185 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef SLUB_ARGUMENTS_H
+#define SLUB_ARGUMENTS_H
+
+#include "config.h"
+#include "converter.h"
+#include "slub_lua.h"
+
+#include <utility>
+
+namespace slub {
+
+  template<int... is>
+  struct indices {
+  };
+
+  template<int n, int... is>
+  struct make_indices : make_indices<n - 1, n - 1, is...> {
+  };
+
+  template<int... is>
+  struct make_indices<0, is...> {
+    typedef indices<is...> type;
+  };
+
+  template<int n, typename... args>
+  struct type_at;
+
+  template<typename A, typename... rest>
+  struct type_at<0, A, rest...> {
+    typedef A type;
+  };
+
+  template<int n, typename A, typename... rest>
+  struct type_at<n, A, rest...> : type_at<n - 1, rest...> {
+  };
+
+  /*
+   a single parameter of a bound callable, lua_State* parameters receive the
+   calling state and take no value from the stack; values are only read after
+   dispatch checked them, so converters offering getUnchecked skip validating
+   them a second time
+   */
+  template<typename A>
+  struct argument {
+
+    enum { stack = 1 };
+
+    static bool check(lua_State* L, int index) {
+      return converter<A>::check(L, index);
+    }
+
+  private:
+
+    template<typename C>
+    static auto fetch(lua_State* L, int index, int) -> decltype(C::getUnchecked(L, index)) {
+      return C::getUnchecked(L, index);
+    }
+
+    template<typename C>
+    static auto fetch(lua_State* L, int index, long) -> decltype(C::get(L, index)) {
+      return C::get(L, index);
+    }
+
+  public:
+
+    static auto get(lua_State* L, int index) -> decltype(fetch<converter<A> >(L, index, 0)) {
+      return fetch<converter<A> >(L, index, 0);
+    }
+
+  };
+
+  template<>
+  struct argument<lua_State*> {
+
+    enum { stack = 0 };
+
+    static bool check(lua_State* L, int index) {
+      return true;
+    }
+
+    static lua_State* get(lua_State* L, int index) {
+      return L;
+    }
+
+  };
+
+  // number of stack values taken by the first n parameters
+  template<int n, typename... args>
+  struct stack_before {
+    enum { value = 0 };
+  };
+
+  template<int n, typename A, typename... rest>
+  struct stack_before<n, A, rest...> {
+    enum { value = n > 0 ? argument<A>::stack + stack_before<n - 1, rest...>::value : 0 };
+  };
+
+  /*
+   the parameters of a bound callable, taken in order from the topmost values
+   of the stack
+   */
+  template<typename... args>
+  struct arguments {
+
+    enum { count = stack_before<sizeof...(args), args...>::value };
+
+    typedef typename make_indices<sizeof...(args)>::type all;
+
+    // the stack holds exactly leading values followed by the parameters
+    static bool check(lua_State* L, int leading) {
+      return lua_gettop(L) == leading + count && checkEach(L, all());
+    }
+
+    template<int i>
+    static auto get(lua_State* L) -> decltype(argument<typename type_at<i, args...>::type>::get(L, 0)) {
+      return argument<typename type_at<i, args...>::type>::get(L, stack_before<i, args...>::value - count);
+    }
+
+  private:
+
+    static bool checkEach(lua_State* L, indices<>) {
+      return true;
+    }
+
+    template<int i, int... is>
+    static bool checkEach(lua_State* L, indices<i, is...>) {
+      return argument<typename type_at<i, args...>::type>::check(L, stack_before<i, args...>::value - count)
+          && checkEach(L, indices<is...>());
+    }
+
+  };
+
+  // calls a bound callable and pushes its result, void results push nothing
+  template<typename ret>
+  struct result {
+
+    template<typename T, typename M, typename... values>
+    static int method(lua_State* L, T* obj, M m, values&&... v) {
+      return converter<ret>::push(L, (obj->*m)(std::forward<values>(v)...));
+    }
+
+    template<typename F, typename... values>
+    static int function(lua_State* L, F f, values&&... v) {
+      return converter<ret>::push(L, f(std::forward<values>(v)...));
+    }
+
+  };
+
+  template<>
+  struct result<void> {
+
+    template<typename T, typename M, typename... values>
+    static int method(lua_State* L, T* obj, M m, values&&... v) {
+      (obj->*m)(std::forward<values>(v)...);
+      return 0;
+    }
+
+    template<typename F, typename... values>
+    static int function(lua_State* L, F f, values&&... v) {
+      f(std::forward<values>(v)...);
+      return 0;
+    }
+
+  };
+
+}
+
+#endif
@@ -24,33 +24,180 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "function.h"
 #include "method.h"
 #include "operators.h"
+#include "pool.h"
 #include "reference.h"
 #include "registry.h"
 #include "slub_lua.h"
 #include "wrapper.h"
 
 #include <utility>
+#include <vector>
 
 namespace slub {
 
   struct deleter {
+    static const bool pooling = false;
+
+    template<typename T>
+    static T* newInstance(lua_State* L, abstract_constructor* ctor) {
+      return ctor->newInstance<T>(L);
+    }
+
     template<typename T>
     static void delete_(wrapper<T*>* w) {
-      if (w->holder != NULL) {
-        delete w->holder;
-      }
-      else {
-        delete w->ref();
-      }
+      delete w->ref();
     }
   };
 
   struct null_deleter {
+    static const bool pooling = false;
+
+    template<typename T>
+    static T* newInstance(lua_State* L, abstract_constructor* ctor) {
+      return ctor->newInstance<T>(L);
+    }
+
     template<typename T>
     static void delete_(wrapper<T*>* w) {
     }
   };
 
+  // per state lookup of the resolved members of a class, keyed by the
+  // interned Lua string of the member name
+  struct member_cache {
+
+    struct slot {
+      const char* key;
+      const member* value;
+      int closure;  // index of the method closure in the anchor table, 0 if none
+    };
+
+    member_cache() : revision(0), scriptRevision(0), anchors(0), indexOperator(NULL) {}
+
+    const slot* find(const char* key) const {
+      if (slots.empty()) {
+        return NULL;
+      }
+      size_t mask = slots.size() - 1;
+      for (size_t idx = hash(key) & mask; slots[idx].key != NULL; idx = (idx + 1) & mask) {
+        if (slots[idx].key == key) {
+          return &slots[idx];
+        }
+      }
+      return NULL;
+    }
+
+    void rebuild(lua_State* L, registry* reg, int anchorTable);
+
+    static int gc(lua_State* L);
+
+    unsigned int revision;
+    unsigned int scriptRevision;
+    int anchors;
+    const member* indexOperator;
+    std::vector<slot> slots;
+
+  private:
+
+    static size_t hash(const char* key) {
+      size_t h = (size_t) key;
+      return h ^ (h >> 4) ^ (h >> 12);
+    }
+
+  };
+
+  // inline cache of a method dispatch closure, maps the dynamic type of
+  // self, the Lua types of the arguments and the classes of the userdata
+  // among them to the resolved overload
+  struct call_cache {
+
+    enum { size = 4, max_args = 8 };
+
+    struct entry {
+      int self;  // classOf self
+      int arity;
+      unsigned int types;
+      int classes[max_args];
+      abstract_method* method;
+      // the key alone decides check(), a hit calls without checking
+      bool exact;
+    };
+
+    call_cache() : revision(0), scriptRevision(0), next(0) {
+      clear();
+    }
+
+    // the class of a userdata in a key, tells const objects apart; -1 for
+    // userdata that are not bound objects
+    static int classOf(lua_State* L, int index) {
+      wrapper_base* w = wrapper_base::of(L, index);
+      return w != NULL ? w->id * 2 + w->constant : -1;
+    }
+
+    // packs the Lua types of the arguments after self and the classes of
+    // userdata, false if there are too many
+    static bool key(lua_State* L, int arity, unsigned int& types, int* classes) {
+      if (arity - 1 > max_args) {
+        return false;
+      }
+      types = 0;
+      for (int idx = 2; idx <= arity; ++idx) {
+        int type = lua_type(L, idx);
+        types = (types << 4) | (unsigned int) (type + 1);
+        classes[idx - 2] = type == LUA_TUSERDATA ? classOf(L, idx) : -1;
+      }
+      return true;
+    }
+
+    const entry* find(int self, int arity, unsigned int types, const int* classes) const {
+      for (int idx = 0; idx < size; ++idx) {
+        const entry& e = entries[idx];
+        if (e.self == self && e.arity == arity && e.types == types && sameClasses(e, classes)) {
+          return &e;
+        }
+      }
+      return NULL;
+    }
+
+    void insert(int self, int arity, unsigned int types, const int* classes, abstract_method* method, bool exact) {
+      entry& e = entries[next];
+      e.self = self;
+      e.arity = arity;
+      e.types = types;
+      for (int idx = 0; idx < arity - 1; ++idx) {
+        e.classes[idx] = classes[idx];
+      }
+      e.method = method;
+      e.exact = exact;
+      next = (next + 1) % size;
+    }
+
+    void clear() {
+      for (int idx = 0; idx < size; ++idx) {
+        entries[idx].self = -1;
+        entries[idx].method = NULL;
+      }
+      next = 0;
+    }
+
+    unsigned int revision;
+    unsigned int scriptRevision;
+    int next;
+    entry entries[size];
+
+  private:
+
+    static bool sameClasses(const entry& e, const int* classes) {
+      for (int idx = 0; idx < e.arity - 1; ++idx) {
+        if (e.classes[idx] != classes[idx]) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+  };
+
   struct abstract_clazz {
     static int index(lua_State* L);
     static int index(lua_State* L, const string& className, bool fallback);
@@ -61,6 +208,18 @@ namespace slub {
     static int callOperator(lua_State* L);
 
   protected:
+    // bumped when a script adds a function to a method table
+    static unsigned int scriptRevision;
+
+    static int methodTableNewindex(lua_State* L);
+
+    // metamethods are only installed for operators the class or a base defines
+    static void addOperatorMetamethod(lua_State* L, registry* reg, const string& name);
+    static void addOperatorMetamethods(lua_State* L, registry* reg, registry* base);
+    static void installOperatorMetamethod(lua_State* L, registry* reg, const string& name);
+
+    static const member_cache::slot* findMember(lua_State* L, registry* reg, int index);
+
     std::pair<int, int> construct(lua_State * state, registry * reg, char const * name, char const * fqname, int target);
     void add_symbols(lua_State * state, registry * reg, int methods, int metatable);
   };
@@ -78,39 +237,30 @@ namespace slub {
       init(L, name, prefix, target);
     }
 
-    template<typename B>
-    clazz& extends() {
-      registry* base = registry::get(typeid(B));
-      reg->registerBase(base);
+    // instances created by Lua or returned by value are constructed inside
+    // their userdata instead of on the heap and destroyed in place
+    clazz& valueStorage() {
+      reg->enableValueStorage(state);
       return *this;
     }
 
-    clazz& constructor() {
-      reg->addConstructor(new slub::constructor<T>());
+    // pushing a pointer that already has a live userdata returns that userdata
+    clazz& instanceCache() {
+      reg->enableInstanceCache(state);
       return *this;
     }
-    
-    template<typename arg1>
-    clazz& constructor() {
-      reg->addConstructor(new slub::constructor<T, arg1>());
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2>
-    clazz& constructor() {
-      reg->addConstructor(new slub::constructor<T, arg1, arg2>());
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3>
-    clazz& constructor() {
-      reg->addConstructor(new slub::constructor<T, arg1, arg2, arg3>());
+
+    template<typename B>
+    clazz& extends() {
+      registry* base = registry::get(typeid(B));
+      reg->registerBase(base);
+      addOperatorMetamethods(state, reg, base);
       return *this;
     }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4>
+
+    template<typename... args>
     clazz& constructor() {
-      reg->addConstructor(new slub::constructor<T, arg1, arg2, arg3, arg4>());
+      reg->addConstructor(new slub::constructor<T, args...>());
       return *this;
     }
     
@@ -150,359 +300,126 @@ namespace slub {
       return *this;
     }
     
-    template<typename ret>
-    clazz& method(const string& methodName, ret (T::*m)()) {
-      reg->addMethod(methodName, new slub::method<T, ret>(m));
-      return *this;
-    }
-    
-    clazz& method(const string& methodName, void (T::*m)()) {
-      reg->addMethod(methodName, new slub::method<T>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1>
-    clazz& method(const string& methodName, ret (T::*m)(arg1)) {
-      reg->addMethod(methodName, new slub::method<T, ret, arg1>(m));
-      return *this;
-    }
-    
-    template<typename arg1>
-    clazz& method(const string& methodName, void (T::*m)(arg1)) {
-      reg->addMethod(methodName, new slub::method<T, void, arg1>(m));
+    template<typename ret, typename... args>
+    clazz& method(const string& methodName, ret (T::*m)(args...)) {
+      reg->addMethod(methodName, new slub::method<T, ret, args...>(m));
       return *this;
     }
     
-    template<typename ret, typename arg1, typename arg2>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2)) {
-      reg->addMethod(methodName, new slub::method<T, ret, arg1, arg2>(m));
+    template<typename ret, typename... args>
+    clazz& method(const string& methodName, ret (T::*m)(args...) const) {
+      reg->addMethod(methodName, new slub::const_method<T, ret, args...>(m));
       return *this;
     }
     
-    template<typename arg1, typename arg2>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2)) {
-      reg->addMethod(methodName, new slub::method<T, void, arg1, arg2>(m));
+    template<typename ret, typename... args>
+    clazz& method(const string& methodName, ret (*m)(T*, args...)) {
+      reg->addMethod(methodName, new slub::func_method<T, ret, args...>(m));
       return *this;
     }
 
-    template<typename ret, typename arg1, typename arg2, typename arg3>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2, arg3)) {
-      reg->addMethod(methodName, new slub::method<T, ret, arg1, arg2, arg3>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2, arg3)) {
-      reg->addMethod(methodName, new slub::method<T, void, arg1, arg2, arg3>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2, arg3, arg4)) {
-      reg->addMethod(methodName, new slub::method<T, ret, arg1, arg2, arg3, arg4>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2, arg3, arg4)) {
-      reg->addMethod(methodName, new slub::method<T, void, arg1, arg2, arg3, arg4>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2, arg3, arg4, arg5)) {
-      reg->addMethod(methodName, new slub::method<T, ret, arg1, arg2, arg3, arg4, arg5>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2, arg3, arg4, arg5)) {
-      reg->addMethod(methodName, new slub::method<T, void, arg1, arg2, arg3, arg4, arg5>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6)) {
-      reg->addMethod(methodName, new slub::method<T, ret, arg1, arg2, arg3, arg4, arg5, arg6>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6)) {
-      reg->addMethod(methodName, new slub::method<T, void, arg1, arg2, arg3, arg4, arg5, arg6>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, arg7)) {
-      reg->addMethod(methodName, new slub::method<T, ret, arg1, arg2, arg3, arg4, arg5>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, arg7)) {
-      reg->addMethod(methodName, new slub::method<T, void, arg1, arg2, arg3, arg4, arg5, arg6, arg7>(m));
-      return *this;
-    }
-    
-    template<typename ret>
-    clazz& method(const string& methodName, ret (T::*m)() const) {
-      reg->addMethod(methodName, new slub::const_method<T, ret>(m));
-      return *this;
-    }
-    
-    clazz& method(const string& methodName, void (T::*m)() const) {
-      reg->addMethod(methodName, new slub::const_method<T>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1>
-    clazz& method(const string& methodName, ret (T::*m)(arg1) const) {
-      reg->addMethod(methodName, new slub::const_method<T, ret, arg1>(m));
-      return *this;
-    }
-    
-    template<typename arg1>
-    clazz& method(const string& methodName, void (T::*m)(arg1) const) {
-      reg->addMethod(methodName, new slub::const_method<T, void, arg1>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2) const) {
-      reg->addMethod(methodName, new slub::const_method<T, ret, arg1, arg2>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2) const) {
-      reg->addMethod(methodName, new slub::const_method<T, void, arg1, arg2>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2, arg3) const) {
-      reg->addMethod(methodName, new slub::const_method<T, ret, arg1, arg2, arg3>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2, arg3, arg4) const) {
-      reg->addMethod(methodName, new slub::const_method<T, void, arg1, arg2, arg3, arg4>(m));
-      return *this;
-    }
+    /*
+     binds m as its own lua_CFunction, bypassing overload dispatch; derived
+     classes inherit it and a function a script assigns to the method table
+     overrides it like any other method. Meant for hot methods with a single
+     overload, the name must not also be bound through method(name, m):
 
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4>
-    clazz& method(const string& methodName, ret (T::*m)(arg1, arg2, arg3, arg4) const) {
-      reg->addMethod(methodName, new slub::const_method<T, ret, arg1, arg2, arg3, arg4>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3>
-    clazz& method(const string& methodName, T* t, void (T::*m)(arg1, arg2, arg3) const) {
-      reg->addMethod(methodName, new slub::const_method<T, void, arg1, arg2, arg3>(m));
-      return *this;
-    }
-    
-    template<typename ret>
-    clazz& method(const string& methodName, ret (*m)(T*)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret>(m));
-      return *this;
-    }
-    
-    clazz& method(const string& methodName, void (*m)(T*)) {
-      reg->addMethod(methodName, new slub::func_method<T>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1>
-    clazz& method(const string& methodName, ret (*m)(T*, arg1)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret, arg1>(m));
-      return *this;
-    }
-    
-    // TODO: add more lua_State* shortcuts
-    template<typename ret>
-    clazz& method(const string& methodName, ret (*m)(T*, lua_State*)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret, lua_State*>(m));
-      return *this;
-    }
-    
-    template<typename arg1>
-    clazz& method(const string& methodName, void (*m)(T*, arg1)) {
-      reg->addMethod(methodName, new slub::func_method<T, void, arg1>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2>
-    clazz& method(const string& methodName, ret (*m)(T*, arg1, arg2)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret, arg1, arg2>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2>
-    clazz& method(const string& methodName, T* t, void (*m)(T*, arg1, arg2)) {
-      reg->addMethod(methodName, new slub::func_method<T, void, arg1, arg2>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3>
-    clazz& method(const string& methodName, ret (*m)(T*, arg1, arg2, arg3)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret, arg1, arg2, arg3>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3>
-    clazz& method(const string& methodName, T* t, void (*m)(T*, arg1, arg2, arg3)) {
-      reg->addMethod(methodName, new slub::func_method<T, void, arg1, arg2, arg3>(m));
+       clazz<T>(L, "T").method<SLUB_STATIC(&T::update)>("update");
+     */
+    template<typename M, M m>
+    clazz& method(const string& methodName) {
+      reg->addDirectMethod(methodName, static_method<M, m>::call);
       return *this;
     }
 
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4>
-    clazz& method(const string& methodName, ret (*m)(T*, arg1, arg2, arg3, arg4)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret, arg1, arg2, arg3, arg4>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4>
-    clazz& method(const string& methodName, T* t, void (*m)(T*, arg1, arg2, arg3, arg4)) {
-      reg->addMethod(methodName, new slub::func_method<T, void, arg1, arg2, arg3, arg4>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-    clazz& method(const string& methodName, ret (*m)(T*, arg1, arg2, arg3, arg4, arg5)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret, arg1, arg2, arg3, arg4, arg5>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-    clazz& method(const string& methodName, T* t, void (*m)(T*, arg1, arg2, arg3, arg4, arg5)) {
-      reg->addMethod(methodName, new slub::func_method<T, void, arg1, arg2, arg3, arg4, arg5>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-    clazz& method(const string& methodName, ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret, arg1, arg2, arg3, arg4, arg5, arg6>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-    clazz& method(const string& methodName, T* t, void (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6)) {
-      reg->addMethod(methodName, new slub::func_method<T, void, arg1, arg2, arg3, arg4, arg5, arg6>(m));
-      return *this;
-    }
-    
-    template<typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-    clazz& method(const string& methodName, ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, arg7)) {
-      reg->addMethod(methodName, new slub::func_method<T, ret, arg1, arg2, arg3, arg4, arg5, arg6, arg7>(m));
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-    clazz& method(const string& methodName, T* t, void (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, arg7)) {
-      reg->addMethod(methodName, new slub::func_method<T, void, arg1, arg2, arg3, arg4, arg5, arg6, arg7>(m));
-      return *this;
+#if __cplusplus >= 201703L
+    template<auto m>
+    clazz& method(const string& methodName) {
+      return method<decltype(m), m>(methodName);
     }
+#endif
     
     clazz& eq() {
-      reg->addOperator("__eq", new eq_operator<T, T>());
-      return *this;
+      return addOperator("__eq", new eq_operator<T, T>());
     }
 
     template<typename F>
     clazz& eq() {
-      reg->addOperator("__eq", new eq_operator<T, F>());
-      return *this;
+      return addOperator("__eq", new eq_operator<T, F>());
     }
     
     clazz& lt() {
-      reg->addOperator("__lt", new lt_operator<T, T>());
-      return *this;
+      return addOperator("__lt", new lt_operator<T, T>());
     }
     
     template<typename F>
     clazz& lt() {
-      reg->addOperator("__lt", new lt_operator<T, F>());
-      return *this;
+      return addOperator("__lt", new lt_operator<T, F>());
     }
     
     clazz& le() {
-      reg->addOperator("__le", new le_operator<T, T>());
-      return *this;
+      return addOperator("__le", new le_operator<T, T>());
     }
     
     template<typename F>
     clazz& le() {
-      reg->addOperator("__le", new le_operator<T, F>());
-      return *this;
+      return addOperator("__le", new le_operator<T, F>());
     }
     
     clazz& tostring() {
-      reg->addOperator("__tostring", new tostring_operator<T>());
-      return *this;
+      return addOperator("__tostring", new tostring_operator<T>());
     }
     
     clazz& tostring_default() {
-      reg->addOperator("__tostring", new lua_tostring_operator<T>());
-      return *this;
+      return addOperator("__tostring", new lua_tostring_operator<T>());
     }
     
     template<typename R, typename F>
     clazz& add() {
-      reg->addOperator("__add", new add_operator<T, R, F>());
-      return *this;
+      return addOperator("__add", new add_operator<T, R, F>());
     }
     
     template<typename R, typename F>
     clazz& sub() {
-      reg->addOperator("__sub", new sub_operator<T, R, F>());
-      return *this;
+      return addOperator("__sub", new sub_operator<T, R, F>());
     }
     
     template<typename R, typename F>
     clazz& mul() {
-      reg->addOperator("__mul", new mul_operator<T, R, F>());
-      return *this;
+      return addOperator("__mul", new mul_operator<T, R, F>());
     }
     
     template<typename R, typename F>
     clazz& div() {
-      reg->addOperator("__div", new div_operator<T, R, F>());
-      return *this;
+      return addOperator("__div", new div_operator<T, R, F>());
     }
     
     template<typename R, typename F>
     clazz& mod() {
-      reg->addOperator("__mod", new mod_operator<T, R, F>());
-      return *this;
+      return addOperator("__mod", new mod_operator<T, R, F>());
     }
     
     template<typename R, typename F>
     clazz& pow() {
-      reg->addOperator("__pow", new pow_operator<T, R, F>());
-      return *this;
+      return addOperator("__pow", new pow_operator<T, R, F>());
     }
     
     clazz& unm() {
-      reg->addOperator("__unm", new unm_operator<T, T>());
-      return *this;
+      return addOperator("__unm", new unm_operator<T, T>());
     }
 
     template<typename R>
     clazz& unm() {
-      reg->addOperator("__unm", new unm_operator<T, R>());
-      return *this;
+      return addOperator("__unm", new unm_operator<T, R>());
     }
     
     template<typename R, typename F>
     clazz& index() {
-      reg->addOperator("__index", new index_operator<T, R, F>());
-      return *this;
+      return addOperator("__index", new index_operator<T, R, F>());
     }
     
-    clazz& function(const string& name, void (*f)()) {
+    template<typename R, typename... args>
+    clazz& function(const string& name, R (*f)(args...)) {
       luaL_getmetatable(state, this->name.c_str());
       lua_getfield(state, -1, "__metatable");
       slub::function(state, name, f, this->name, lua_gettop(state));
@@ -510,141 +427,6 @@ namespace slub {
       return *this;
     }
     
-    template<typename arg1>
-    clazz& function(const string& name, void (*f)(arg1)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<arg1>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2>
-    clazz& function(const string& name, void (*f)(arg1, arg2)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<arg1, arg2>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3>
-    clazz& function(const string& name, void (*f)(arg1, arg2, arg3)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<arg1, arg2, arg3>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4>
-    clazz& function(const string& name, void (*f)(arg1, arg2, arg3, arg4)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<arg1, arg2, arg3, arg4>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-    clazz& function(const string& name, void (*f)(arg1, arg2, arg3, arg4, arg5)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<arg1, arg2, arg3, arg4, arg5>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-    clazz& function(const string& name, void (*f)(arg1, arg2, arg3, arg4, arg5, arg6)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<arg1, arg2, arg3, arg4, arg5, arg6>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-    clazz& function(const string& name, void (*f)(arg1, arg2, arg3, arg4, arg5, arg6, arg7)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<arg1, arg2, arg3, arg4, arg5, arg6, arg7>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename R>
-    clazz& function(const string& name, R (*f)()) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<R>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename R, typename arg1>
-    clazz& function(const string& name, R (*f)(arg1)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<R, arg1>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2>
-    clazz& function(const string& name, R (*f)(arg1, arg2)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<R, arg1, arg2>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3>
-    clazz& function(const string& name, R (*f)(arg1, arg2, arg3)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<R, arg1, arg2, arg3>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3, typename arg4>
-    clazz& function(const string& name, R (*f)(arg1, arg2, arg3, arg4)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<R, arg1, arg2, arg3, arg4>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-    clazz& function(const string& name, R (*f)(arg1, arg2, arg3, arg4, arg5)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<R, arg1, arg2, arg3, arg4, arg5>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-    clazz& function(const string& name, R (*f)(arg1, arg2, arg3, arg4, arg5, arg6)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<R, arg1, arg2, arg3, arg4, arg5, arg6>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-    clazz& function(const string& name, R (*f)(arg1, arg2, arg3, arg4, arg5, arg6, arg7)) {
-      luaL_getmetatable(state, this->name.c_str());
-      lua_getfield(state, -1, "__metatable");
-      slub::function<R, arg1, arg2, arg3, arg4, arg5, arg6, arg7>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 2);
-      return *this;
-    }
-    
     template<typename C>
     clazz& enumerated(const string& constantName, const C& value) {
       return constant<int>(constantName, value);
@@ -669,6 +451,12 @@ namespace slub {
     static T* clazz_cast(const reference& ref) {
       return ref.cast<T*>();
     }
+
+    clazz& addOperator(const string& operatorName, abstract_operator* op) {
+      reg->addOperator(operatorName, op);
+      addOperatorMetamethod(state, reg, operatorName);
+      return *this;
+    }
     
     void init(lua_State* L, const string& name, const string& prefix = "", int target = -1)
     {
@@ -686,6 +474,9 @@ namespace slub {
       lua_pushliteral(state, "__call");
       lua_pushcfunction(state, call);
       lua_settable(state, mt);            // mt.__call = ctor
+      lua_pushliteral(state, "__newindex");
+      lua_pushcfunction(state, methodTableNewindex);
+      lua_settable(state, mt);            // mt.__newindex = invalidate call caches
       lua_setmetatable(state, methods);
       
       lua_pushliteral(state, "__gc");
@@ -700,11 +491,25 @@ namespace slub {
     static int call(lua_State* L) {
       registry* r = registry::get(typeid(T));
       if (r->containsConstructor()) {
-        T* instance = r->getConstructor(L)->newInstance<T>(L);
-        wrapper<T*>* w = wrapper<T*>::create(L, typeid(T));
-        w->ref(instance);
+        abstract_constructor* ctor = r->getConstructor(L);
+        wrapper<T*>* w;
+        if (r->valueStorage(L)) {
+          // the arguments are read relative to the top, keep them there
+          void* storage;
+          w = wrapper<T*>::template create<T>(L, typeid(T), storage);
+          lua_insert(L, 1);
+          w->ref(ctor->newInstance<T>(L, storage));
+          w->inplace = true;
+          lua_pushvalue(L, 1);
+        }
+        else {
+          T* instance = D::template newInstance<T>(L, ctor);
+          w = wrapper<T*>::create(L, typeid(T));
+          w->ref(instance);
+          w->pooled = D::pooling;
+        }
         w->gc = true;
-        luaL_getmetatable(L, r->getTypeName().c_str());
+        r->pushMetatable(L);
         lua_setmetatable(L, -2);
         return 1;
       }
@@ -714,12 +519,13 @@ namespace slub {
     static int gc(lua_State* L) {
       wrapper<T*>* w = static_cast<wrapper<T*>*>(luaL_checkudata(L, 1, registry::get(typeid(T))->getTypeName().c_str()));
 
-      registry* r = registry::get(typeid(T));
-      if (r != NULL) {
-        r->removeInstanceTable(L, w->raw);
+      if (w->inplace) {
+        w->ref()->~T();
       }
-
-      if (w->gc) {
+      else if (w->holderKind != holder_none) {
+        w->releaseHolder();
+      }
+      else if (w->gc) {
         D::delete_(w);
       }
       else {
@@ -50,6 +50,30 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
   #define SLUB_MAP_TYPE std::map
 #endif
 
+/*
+ configurable hash map include/type for slub's internal lookup tables,
+ keyed by strings and pointers; takes key and value type
+ */
+#ifndef SLUB_HASH_MAP_INCLUDE
+  #define SLUB_HASH_MAP_INCLUDE "containers.h"
+#endif
+
+#ifndef SLUB_HASH_MAP_TYPE
+  #define SLUB_HASH_MAP_TYPE slub::flat_map
+#endif
+
+/*
+ configurable small list include/type for slub's internal lists, which
+ usually hold a handful of entries; takes the element type
+ */
+#ifndef SLUB_SMALL_LIST_INCLUDE
+  #define SLUB_SMALL_LIST_INCLUDE "containers.h"
+#endif
+
+#ifndef SLUB_SMALL_LIST_TYPE
+  #define SLUB_SMALL_LIST_TYPE slub::small_vector
+#endif
+
 /*
  you shouldn't change anything below this line
  */
@@ -57,6 +81,8 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include SLUB_STRING_INCLUDE
 #include SLUB_LIST_INCLUDE
 #include SLUB_MAP_INCLUDE
+#include SLUB_HASH_MAP_INCLUDE
+#include SLUB_SMALL_LIST_INCLUDE
 
 namespace slub {
 
@@ -64,6 +90,12 @@ namespace slub {
   using SLUB_LIST_TYPE;
   using SLUB_MAP_TYPE;
 
+  template<typename K, typename V>
+  using hash_map = SLUB_HASH_MAP_TYPE<K, V>;
+
+  template<typename T>
+  using small_list = SLUB_SMALL_LIST_TYPE<T>;
+
 }
 
 #endif
@@ -18,135 +18,97 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define SLUB_CONSTRUCTOR_H
 
 #include "slub_lua.h"
+#include "arguments.h"
 #include "converter.h"
+#include "dispatch.h"
+
+#include <new>
+#include <utility>
 
 namespace slub {
 
   struct abstract_constructor {
 
+    abstract_constructor() {}
+    abstract_constructor(const signature& sig) : sig(sig) {}
+
     virtual bool check(lua_State* L) = 0;
     virtual void* _newInstance(lua_State* L) = 0;
+    virtual void* _newInstance(lua_State* L, void* storage) = 0;
+    virtual void* _newInstance(lua_State* L, void* (*allocate)(), void (*deallocate)(void*)) = 0;
 
     template<typename T>
     T* newInstance(lua_State* L) {
       return (T*) _newInstance(L);
     }
 
+    // constructs the instance in storage
+    template<typename T>
+    T* newInstance(lua_State* L, void* storage) {
+      return (T*) _newInstance(L, storage);
+    }
+
+    // takes the storage from allocate only once all arguments are converted,
+    // a converter raising a Lua error longjmps past any cleanup
+    template<typename T>
+    T* newInstance(lua_State* L, void* (*allocate)(), void (*deallocate)(void*)) {
+      return (T*) _newInstance(L, allocate, deallocate);
+    }
+
+    signature sig;
+
   };
 
-  template<typename T, typename arg1 = empty, typename arg2 = empty, typename arg3 = empty, typename arg4 = empty>
+  template<typename T, typename... args>
   struct constructor : public abstract_constructor {
 
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
-    }
-    
-    void* _newInstance(lua_State* L) {
-      return new T(converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1));
-    }
-    
-  };
-  
-  template<typename T>
-  struct constructor<T, empty, empty, empty, empty> : public abstract_constructor {
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    void* _newInstance(lua_State* L) {
-      return new T();
-    }
-    
-  };
-  
-  template<typename T>
-  struct constructor<T, lua_State*, empty, empty, empty> : public abstract_constructor {
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    void* _newInstance(lua_State* L) {
-      return new T(L);
-    }
-    
-  };
-  
-  template<typename T, typename arg1>
-  struct constructor<T, arg1, empty, empty, empty> : public abstract_constructor {
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    void* _newInstance(lua_State* L) {
-      return new T(converter<arg1>::get(L, -1));
+    constructor() : abstract_constructor(signature::of<args...>(1)) {
     }
     
-  };
-  
-  template<typename T, typename arg1>
-  struct constructor<T, arg1, lua_State*, empty, empty> : public abstract_constructor {
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    void* _newInstance(lua_State* L) {
-      return new T(converter<arg1>::get(L, -1), L);
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2>
-  struct constructor<T, arg1, arg2, empty, empty> : public abstract_constructor {
-    
     bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
+      return arguments<args...>::check(L, 1);
     }
     
     void* _newInstance(lua_State* L) {
-      return new T(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1));
+      return create(L, typename arguments<args...>::all());
     }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2>
-  struct constructor<T, arg1, arg2, lua_State*, empty> : public abstract_constructor {
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
+
+    void* _newInstance(lua_State* L, void* storage) {
+      return create(L, storage, typename arguments<args...>::all());
     }
-    
-    void* _newInstance(lua_State* L) {
-      return new T(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1), L);
+
+    void* _newInstance(lua_State* L, void* (*allocate)(), void (*deallocate)(void*)) {
+      return create(L, allocate, deallocate, typename arguments<args...>::all());
     }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3>
-  struct constructor<T, arg1, arg2, arg3, empty> : public abstract_constructor {
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
+
+  private:
+
+    template<int... is>
+    T* create(lua_State* L, indices<is...>) {
+      return new T(arguments<args...>::template get<is>(L)...);
     }
-    
-    void* _newInstance(lua_State* L) {
-      return new T(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1));
+
+    template<int... is>
+    T* create(lua_State* L, void* storage, indices<is...>) {
+      return new (storage) T(arguments<args...>::template get<is>(L)...);
     }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3>
-  struct constructor<T, arg1, arg2, arg3, lua_State*> : public abstract_constructor {
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
+
+    // the arguments are converted before construct is entered
+    template<int... is>
+    T* create(lua_State* L, void* (*allocate)(), void (*deallocate)(void*), indices<is...>) {
+      return construct(allocate, deallocate, arguments<args...>::template get<is>(L)...);
     }
-    
-    void* _newInstance(lua_State* L) {
-      return new T(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1), L);
+
+    template<typename... values>
+    static T* construct(void* (*allocate)(), void (*deallocate)(void*), values&&... v) {
+      void* storage = allocate();
+      try {
+        return new (storage) T(std::forward<values>(v)...);
+      }
+      catch (...) {
+        deallocate(storage);
+        throw;
+      }
     }
     
   };
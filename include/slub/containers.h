@@ -0,0 +1,355 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SLUB_CONTAINERS_H
+#define SLUB_CONTAINERS_H
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace slub {
+
+  // strings are hashed through c_str() so any configured string type works,
+  // everything else falls back to std::hash
+  template<typename K>
+  struct hash {
+
+    size_t operator()(const K& key) const {
+      return value(key, 0);
+    }
+
+  private:
+
+    template<typename S>
+    static auto value(const S& s, int) -> decltype(s.c_str(), s.size(), size_t()) {
+      const char* str = s.c_str();
+      size_t h = 2166136261u;
+      for (size_t idx = 0; idx < s.size(); ++idx) {
+        h = (h ^ (unsigned char) str[idx]) * 16777619u;
+      }
+      return h;
+    }
+
+    template<typename S>
+    static size_t value(const S& s, long) {
+      return std::hash<S>()(s);
+    }
+
+  };
+
+  // the low bits of heap pointers are mostly zero, mix them before masking
+  template<typename T>
+  struct hash<T*> {
+
+    size_t operator()(T* key) const {
+      size_t v = (size_t) key;
+      v = (v >> 3) ^ (v >> 17);
+      return v * 2654435761u;
+    }
+
+  };
+
+  // open addressing hash map keeping its entries in one vector, the probe
+  // table holds only hashes and indices; iteration is in no particular order
+  // and erase moves the last entry into the gap
+  template<typename K, typename V, typename H = hash<K> >
+  struct flat_map {
+
+    typedef std::pair<K, V> value_type;
+    typedef typename std::vector<value_type>::iterator iterator;
+    typedef typename std::vector<value_type>::const_iterator const_iterator;
+
+    flat_map() : mask(0) {}
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+
+    iterator find(const K& key) {
+      size_t idx = locate(key, H()(key));
+      return idx == npos ? entries.end() : entries.begin() + (slots[idx].index - 1);
+    }
+
+    const_iterator find(const K& key) const {
+      size_t idx = locate(key, H()(key));
+      return idx == npos ? entries.end() : entries.begin() + (slots[idx].index - 1);
+    }
+
+    V& operator[](const K& key) {
+      size_t h = H()(key);
+      size_t idx = locate(key, h);
+      if (idx != npos) {
+        return entries[slots[idx].index - 1].second;
+      }
+      if ((entries.size() + 1) * 4 > slots.size() * 3) {
+        rehash(slots.empty() ? 8 : slots.size() * 2);
+      }
+      entries.push_back(value_type(key, V()));
+      place(h, entries.size());
+      return entries.back().second;
+    }
+
+    size_t erase(const K& key) {
+      size_t idx = locate(key, H()(key));
+      if (idx == npos) {
+        return 0;
+      }
+      size_t index = slots[idx].index - 1;
+      remove(idx);
+
+      size_t last = entries.size() - 1;
+      if (index != last) {
+        idx = locate(entries[last].first, H()(entries[last].first));
+        slots[idx].index = (unsigned int) index + 1;
+        entries[index] = std::move(entries[last]);
+      }
+      entries.pop_back();
+      return 1;
+    }
+
+    void clear() {
+      entries.clear();
+      slots.clear();
+      mask = 0;
+    }
+
+  private:
+
+    // index is one based, zero marks a free slot
+    struct slot {
+      unsigned int hash;
+      unsigned int index;
+    };
+
+    static const size_t npos = (size_t) -1;
+
+    size_t locate(const K& key, size_t h) const {
+      if (slots.empty()) {
+        return npos;
+      }
+      for (size_t idx = h & mask; ; idx = (idx + 1) & mask) {
+        const slot& s = slots[idx];
+        if (s.index == 0) {
+          return npos;
+        }
+        if (s.hash == (unsigned int) h && entries[s.index - 1].first == key) {
+          return idx;
+        }
+      }
+    }
+
+    void place(size_t h, size_t index) {
+      size_t idx = h & mask;
+      while (slots[idx].index != 0) {
+        idx = (idx + 1) & mask;
+      }
+      slots[idx].hash = (unsigned int) h;
+      slots[idx].index = (unsigned int) index;
+    }
+
+    // backward shift deletion, keeps probe sequences intact without tombstones
+    void remove(size_t idx) {
+      size_t next = idx;
+      for (;;) {
+        next = (next + 1) & mask;
+        if (slots[next].index == 0) {
+          break;
+        }
+        size_t home = slots[next].hash & mask;
+        bool between = idx <= next ? (idx < home && home <= next) : (idx < home || home <= next);
+        if (!between) {
+          slots[idx] = slots[next];
+          idx = next;
+        }
+      }
+      slots[idx].index = 0;
+    }
+
+    void rehash(size_t capacity) {
+      std::vector<slot> old;
+      old.swap(slots);
+      slots.resize(capacity);
+      for (size_t idx = 0; idx < capacity; ++idx) {
+        slots[idx].index = 0;
+      }
+      mask = capacity - 1;
+      for (size_t idx = 0; idx < old.size(); ++idx) {
+        if (old[idx].index != 0) {
+          place(old[idx].hash, old[idx].index);
+        }
+      }
+    }
+
+    std::vector<value_type> entries;
+    std::vector<slot> slots;
+    size_t mask;
+
+  };
+
+  // vector keeping up to N elements inline before it moves to the heap; most
+  // overload and base lists of a type hold one or two entries
+  template<typename T, size_t N = 4>
+  struct small_vector {
+
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    small_vector() : first(local()), count(0), capacity(N) {}
+
+    small_vector(const small_vector& other) : first(local()), count(0), capacity(N) {
+      reserve(other.count);
+      for (size_t idx = 0; idx < other.count; ++idx) {
+        new (first + idx) T(other.first[idx]);
+      }
+      count = other.count;
+    }
+
+    small_vector(small_vector&& other) : first(local()), count(0), capacity(N) {
+      take(other);
+    }
+
+    ~small_vector() {
+      clear();
+      if (first != local()) {
+        ::operator delete(first);
+      }
+    }
+
+    small_vector& operator=(const small_vector& other) {
+      if (this != &other) {
+        small_vector copy(other);
+        clear();
+        take(copy);
+      }
+      return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) {
+      if (this != &other) {
+        clear();
+        take(other);
+      }
+      return *this;
+    }
+
+    iterator begin() { return first; }
+    iterator end() { return first + count; }
+    const_iterator begin() const { return first; }
+    const_iterator end() const { return first + count; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    T& operator[](size_t idx) { return first[idx]; }
+    const T& operator[](size_t idx) const { return first[idx]; }
+    T& front() { return first[0]; }
+    const T& front() const { return first[0]; }
+    T& back() { return first[count - 1]; }
+    const T& back() const { return first[count - 1]; }
+
+    void push_back(const T& value) {
+      if (count == capacity) {
+        T copy(value);
+        reserve(capacity * 2);
+        new (first + count) T(std::move(copy));
+      }
+      else {
+        new (first + count) T(value);
+      }
+      ++count;
+    }
+
+    void pop_back() {
+      first[--count].~T();
+    }
+
+    iterator erase(iterator pos) {
+      for (iterator idx = pos; idx + 1 != end(); ++idx) {
+        *idx = std::move(*(idx + 1));
+      }
+      pop_back();
+      return pos;
+    }
+
+    void clear() {
+      while (count > 0) {
+        pop_back();
+      }
+    }
+
+    void reserve(size_t size) {
+      if (size <= capacity) {
+        return;
+      }
+      T* storage = static_cast<T*>(::operator new(size * sizeof(T)));
+      for (size_t idx = 0; idx < count; ++idx) {
+        new (storage + idx) T(std::move(first[idx]));
+        first[idx].~T();
+      }
+      if (first != local()) {
+        ::operator delete(first);
+      }
+      first = storage;
+      capacity = size;
+    }
+
+  private:
+
+    T* local() {
+      return reinterpret_cast<T*>(&inline_);
+    }
+
+    // expects this to be empty, leaves other empty
+    void take(small_vector& other) {
+      if (other.first != other.local()) {
+        if (first != local()) {
+          ::operator delete(first);
+        }
+        first = other.first;
+        capacity = other.capacity;
+        count = other.count;
+        other.first = other.local();
+        other.capacity = N;
+        other.count = 0;
+      }
+      else {
+        for (size_t idx = 0; idx < other.count; ++idx) {
+          new (first + idx) T(std::move(other.first[idx]));
+        }
+        count = other.count;
+        other.clear();
+      }
+    }
+
+    T* first;
+    size_t count;
+    size_t capacity;
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type inline_;
+
+  };
+
+}
+
+#endif
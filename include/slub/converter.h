@@ -18,15 +18,19 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define SLUB_CONVERTER_H
 
 #include "config.h"
+#include "dispatch.h"
 #include "registry.h"
 #include "wrapper.h"
 
 #include <stdexcept>
 #include <iostream>
+#include <memory>
 #include <typeinfo>
+#include <utility>
 
 namespace boost {
   template<class T> class shared_ptr;
+  template<class T> class intrusive_ptr;
 }
 
 namespace std {
@@ -40,12 +44,18 @@ namespace slub {
   template<typename T>
   struct converter {
 
+    static const int lua_types = lua_types_of<T*>::value;
+
+    // const objects are accepted, the value is read or copied
     static bool check(lua_State* L, int index) {
-      return converter<T*>::check(L, index);
+      return converter<T*>::checkClass(L, index);
     }
 
     static void* checkudata(lua_State* L, int index) {
-      return converter<T*>::checkudata(L, index);
+      if (!check(L, index)) {
+        luaL_typerror(L, index, registry::get(typeid(T))->getTypeName().c_str());
+      }
+      return lua_touserdata(L, index);
     }
 
     static T& get(lua_State* L, int index) {
@@ -57,13 +67,39 @@ namespace slub {
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
     }
 
+    // index already passed check, the class is not tested again
+    static T& getUnchecked(lua_State* L, int index) {
+      return *static_cast<T*>(((wrapper_base*) lua_touserdata(L, index))->raw);
+    }
+
     static int push(lua_State* L, const T& value) {
+      return pushValue(L, value);
+    }
+
+    // temporaries, e.g. the results of bound calls, are moved into their storage
+    static int push(lua_State* L, T&& value) {
+      return pushValue(L, std::move(value));
+    }
+
+  private:
+
+    template<typename V>
+    static int pushValue(lua_State* L, V&& value) {
       if (registry::isRegisteredType<T>()) {
 //        std::cout << "push, registered" << std::endl;
-        wrapper<T*>* w = wrapper<T*>::create(L, typeid(value));
-        w->ref(new T(value));
+        wrapper<T*>* w;
+        if (registry::byId(registry::typeId<T>())->valueStorage(L)) {
+          void* storage;
+          w = wrapper<T*>::template create<T>(L, typeid(T), storage);
+          w->ref(new (storage) T(std::forward<V>(value)));
+          w->inplace = true;
+        }
+        else {
+          w = wrapper<T*>::create(L, typeid(value));
+          w->ref(new T(std::forward<V>(value)));
+        }
         w->gc = true;
-        luaL_getmetatable(L, registry::get(typeid(value))->getTypeName().c_str());
+        w->reg()->pushMetatable(L);
         lua_setmetatable(L, -2);
         return 1;
       }
@@ -75,37 +111,27 @@ namespace slub {
   template<typename T>
   struct converter<T*> {
 
-    static bool checkBases(registry* reg) {
-      bool result = false;
-      const list<registry*> base = reg->baseList();
-      for (list<registry*>::const_iterator idx = base.begin(); !result && idx != base.end(); ++idx) {
-        result = (*idx)->getType() == typeid(T);
-        if (!result && (*idx)->hasBase()) {
-          result = checkBases(*idx);
-        }
-      }
-      return result;
+    static const int lua_types = lua_types_userdata | lua_types_lightuserdata;
+
+    // value is a userdata of T or a type derived from it, const or not?
+    static bool checkClass(lua_State* L, int index) {
+      wrapper_base* w = wrapper_base::of(L, index);
+      registry* reg = w != NULL ? w->reg() : NULL;
+      return reg != NULL && reg->isA(registry::typeId<T>());
     }
 
+    // objects pushed as const do not convert to T*
     static bool check(lua_State* L, int index) {
-      bool result = false;
-      wrapper_base* w = (wrapper_base*) lua_touserdata(L, index);
-      if (w != NULL) {  // value is a userdata?
-        result = *w->type == typeid(T);
-        if (!result) {
-          registry* reg = registry::get(*w->type);
-          if (reg != NULL && reg->hasBase()) {
-            result = checkBases(reg);
-          }
-        }
-      }
-      return result;
+      return checkClass(L, index) && !((wrapper_base*) lua_touserdata(L, index))->constant;
     }
     
     static void* checkudata(lua_State* L, int index) {
-      if (!check(L, index)) {
+      if (!checkClass(L, index)) {
         luaL_typerror(L, index, registry::get(typeid(T))->getTypeName().c_str());
       }
+      if (((wrapper_base*) lua_touserdata(L, index))->constant) {
+        luaL_argerror(L, index, "const object");
+      }
       return lua_touserdata(L, index);
     }
     
@@ -117,6 +143,11 @@ namespace slub {
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
     }
+
+    // index already passed check, the class is not tested again
+    static T* getUnchecked(lua_State* L, int index) {
+      return static_cast<T*>(((wrapper_base*) lua_touserdata(L, index))->raw);
+    }
     
     static int push(lua_State* L, T* value) {
       return push(L, value, false);
@@ -129,11 +160,19 @@ namespace slub {
       }
       if (registry::isRegisteredType<T>()) {
           //        std::cout << "push, registered" << std::endl;
-        wrapper<T*>* w = wrapper<T*>::create(L, typeid(*value));
+        registry* reg = registry::get(typeid(*value));
+        if (reg != NULL && reg->pushCachedInstance(L, (void*) value)) {
+          if (gc) {
+            static_cast<wrapper<T*>*>(lua_touserdata(L, -1))->gc = true;
+          }
+          return 1;
+        }
+        wrapper<T*>* w = wrapper<T*>::create(L, typeid(*value), reg);
         w->ref(value);
         w->gc = gc;
-        luaL_getmetatable(L, registry::get(typeid(*value))->getTypeName().c_str());
+        reg->pushMetatable(L);
         lua_setmetatable(L, -2);
+        reg->cacheInstance(L, (void*) value);
         return 1;
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
@@ -141,16 +180,11 @@ namespace slub {
     
   };
 
-  template<typename T>
-  struct shared_ptr_holder : public holder_base {
-    T s_ptr;
-    shared_ptr_holder(const T& s_ptr) : s_ptr(s_ptr) {}
-    virtual ~shared_ptr_holder() { s_ptr.reset(); }
-  };
-
   template<typename T>
   struct converter<boost::shared_ptr<T> > {
     
+    static const int lua_types = lua_types_of<T>::value;
+    
     static bool check(lua_State* L, int index) {
       return converter<T>::check(L, index);
     }
@@ -158,14 +192,27 @@ namespace slub {
     static boost::shared_ptr<T>& get(lua_State* L, int index) {
       if (registry::isRegisteredType<T>()) {
 //        std::cout << "get, registered" << std::endl;
-        wrapper<T*, shared_ptr_holder<boost::shared_ptr<T> >*>* w =
-          static_cast<wrapper<T*, shared_ptr_holder<boost::shared_ptr<T> >*>*>(converter<T>::checkudata(L, index));
-        return w->holder->s_ptr;
+        wrapper<T*, boost::shared_ptr<T> >* w = static_cast<wrapper<T*, boost::shared_ptr<T> >*>(converter<T>::checkudata(L, index));
+        if (w->holderKind != holder_boost_shared_ptr) {
+          luaL_argerror(L, index, "not held by a shared pointer");
+        }
+        return w->holder;
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
     }
     
     static int push(lua_State* L, const boost::shared_ptr<T>& value) {
+      return pushPtr(L, value);
+    }
+    
+    static int push(lua_State* L, boost::shared_ptr<T>&& value) {
+      return pushPtr(L, std::move(value));
+    }
+
+  private:
+
+    template<typename P>
+    static int pushPtr(lua_State* L, P&& value) {
       if (value.get() == NULL) {
         lua_pushnil(L);
         return 1;
@@ -179,13 +226,20 @@ namespace slub {
           reg = registry::get(*type);
         }
         if (reg != NULL) {
-          wrapper<T*, shared_ptr_holder<boost::shared_ptr<T> >*>* w =
-            wrapper<T*, shared_ptr_holder<boost::shared_ptr<T> >*>::create(L, *type);
-          w->holder = new shared_ptr_holder<boost::shared_ptr<T> >(value);
+          // a cached userdata is only reused if it holds the same kind of pointer
+          if (reg->pushCachedInstance(L, value.get())) {
+            if (static_cast<wrapper_base*>(lua_touserdata(L, -1))->holderKind == holder_boost_shared_ptr) {
+              return 1;
+            }
+            lua_pop(L, 1);
+          }
+          wrapper<T*, boost::shared_ptr<T> >* w = wrapper<T*, boost::shared_ptr<T> >::create(L, *type, reg);
           w->ref(value.get());
+          w->hold(std::forward<P>(value), holder_boost_shared_ptr);
           w->gc = true;
-          luaL_getmetatable(L, reg->getTypeName().c_str());
+          reg->pushMetatable(L);
           lua_setmetatable(L, -2);
+          reg->cacheInstance(L, w->raw);
           return 1;
         }
       }
@@ -203,6 +257,8 @@ namespace slub {
   template<typename T>
   struct converter<std::tr1::shared_ptr<T> > {
     
+    static const int lua_types = lua_types_of<T>::value;
+    
     static bool check(lua_State* L, int index) {
       return converter<T>::check(L, index);
     }
@@ -210,14 +266,27 @@ namespace slub {
     static std::tr1::shared_ptr<T>& get(lua_State* L, int index) {
       if (registry::isRegisteredType<T>()) {
 //        std::cout << "get, registered" << std::endl;
-        wrapper<T*, shared_ptr_holder<std::tr1::shared_ptr<T> >*>* w =
-          static_cast<wrapper<T*, shared_ptr_holder<std::tr1::shared_ptr<T> >*>*>(converter<T>::checkudata(L, index));
-        return w->holder->s_ptr;
+        wrapper<T*, std::tr1::shared_ptr<T> >* w = static_cast<wrapper<T*, std::tr1::shared_ptr<T> >*>(converter<T>::checkudata(L, index));
+        if (w->holderKind != holder_tr1_shared_ptr) {
+          luaL_argerror(L, index, "not held by a shared pointer");
+        }
+        return w->holder;
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
     }
     
     static int push(lua_State* L, const std::tr1::shared_ptr<T>& value) {
+      return pushPtr(L, value);
+    }
+    
+    static int push(lua_State* L, std::tr1::shared_ptr<T>&& value) {
+      return pushPtr(L, std::move(value));
+    }
+
+  private:
+
+    template<typename P>
+    static int pushPtr(lua_State* L, P&& value) {
       if (value.get() == NULL) {
         lua_pushnil(L);
         return 1;
@@ -231,13 +300,20 @@ namespace slub {
           reg = registry::get(*type);
         }
         if (reg != NULL) {
-          wrapper<T*, shared_ptr_holder<std::tr1::shared_ptr<T> >*>* w =
-            wrapper<T*, shared_ptr_holder<std::tr1::shared_ptr<T> >*>::create(L, *type);
-          w->holder = new shared_ptr_holder<std::tr1::shared_ptr<T> >(value);
+          // a cached userdata is only reused if it holds the same kind of pointer
+          if (reg->pushCachedInstance(L, value.get())) {
+            if (static_cast<wrapper_base*>(lua_touserdata(L, -1))->holderKind == holder_tr1_shared_ptr) {
+              return 1;
+            }
+            lua_pop(L, 1);
+          }
+          wrapper<T*, std::tr1::shared_ptr<T> >* w = wrapper<T*, std::tr1::shared_ptr<T> >::create(L, *type, reg);
           w->ref(value.get());
+          w->hold(std::forward<P>(value), holder_tr1_shared_ptr);
           w->gc = true;
-          luaL_getmetatable(L, reg->getTypeName().c_str());
+          reg->pushMetatable(L);
           lua_setmetatable(L, -2);
+          reg->cacheInstance(L, w->raw);
           return 1;
         }
       }
@@ -255,6 +331,8 @@ namespace slub {
     template<typename T>
     struct converter<std::shared_ptr<T> > {
         
+        static const int lua_types = lua_types_of<T>::value;
+        
         static bool check(lua_State* L, int index) {
             return converter<T>::check(L, index);
         }
@@ -262,14 +340,27 @@ namespace slub {
         static std::shared_ptr<T>& get(lua_State* L, int index) {
             if (registry::isRegisteredType<T>()) {
                 //        std::cout << "get, registered" << std::endl;
-                wrapper<T*, shared_ptr_holder<std::shared_ptr<T> >*>* w =
-                static_cast<wrapper<T*, shared_ptr_holder<std::shared_ptr<T> >*>*>(converter<T>::checkudata(L, index));
-                return w->holder->s_ptr;
+                wrapper<T*, std::shared_ptr<T> >* w = static_cast<wrapper<T*, std::shared_ptr<T> >*>(converter<T>::checkudata(L, index));
+                if (w->holderKind != holder_std_shared_ptr) {
+                luaL_argerror(L, index, "not held by a shared pointer");
+                }
+                return w->holder;
             }
             throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
         }
         
         static int push(lua_State* L, const std::shared_ptr<T>& value) {
+            return pushPtr(L, value);
+        }
+        
+        static int push(lua_State* L, std::shared_ptr<T>&& value) {
+            return pushPtr(L, std::move(value));
+        }
+
+    private:
+
+        template<typename P>
+        static int pushPtr(lua_State* L, P&& value) {
             if (value.get() == NULL) {
                 lua_pushnil(L);
                 return 1;
@@ -283,13 +374,20 @@ namespace slub {
                     reg = registry::get(*type);
                 }
                 if (reg != NULL) {
-                    wrapper<T*, shared_ptr_holder<std::shared_ptr<T> >*>* w =
-                    wrapper<T*, shared_ptr_holder<std::shared_ptr<T> >*>::create(L, *type);
-                    w->holder = new shared_ptr_holder<std::shared_ptr<T> >(value);
+                    // a cached userdata is only reused if it holds the same kind of pointer
+                    if (reg->pushCachedInstance(L, value.get())) {
+                        if (static_cast<wrapper_base*>(lua_touserdata(L, -1))->holderKind == holder_std_shared_ptr) {
+                            return 1;
+                        }
+                        lua_pop(L, 1);
+                    }
+                    wrapper<T*, std::shared_ptr<T> >* w = wrapper<T*, std::shared_ptr<T> >::create(L, *type, reg);
                     w->ref(value.get());
+                    w->hold(std::forward<P>(value), holder_std_shared_ptr);
                     w->gc = true;
-                    luaL_getmetatable(L, reg->getTypeName().c_str());
+                    reg->pushMetatable(L);
                     lua_setmetatable(L, -2);
+                    reg->cacheInstance(L, w->raw);
                     return 1;
                 }
             }
@@ -304,9 +402,96 @@ namespace slub {
     template<typename T>
     struct converter<const std::shared_ptr<T>&> : converter<std::shared_ptr<T> > {};
     
+  // the reference count lives in the object, the userdata holds one reference
+  // through an in place intrusive_ptr, any userdata of T converts back
+  template<typename T>
+  struct converter<boost::intrusive_ptr<T> > {
+
+    static const int lua_types = lua_types_of<T>::value;
+
+    static bool check(lua_State* L, int index) {
+      return converter<T>::check(L, index);
+    }
+
+    static boost::intrusive_ptr<T> get(lua_State* L, int index) {
+      return boost::intrusive_ptr<T>(converter<T*>::get(L, index));
+    }
+
+    static int push(lua_State* L, const boost::intrusive_ptr<T>& value) {
+      return pushPtr(L, value);
+    }
+
+    static int push(lua_State* L, boost::intrusive_ptr<T>&& value) {
+      return pushPtr(L, std::move(value));
+    }
+
+  private:
+
+    template<typename P>
+    static int pushPtr(lua_State* L, P&& value) {
+      if (value.get() == NULL) {
+        lua_pushnil(L);
+        return 1;
+      }
+      if (registry::isRegisteredType<T>()) {
+        const std::type_info* type = &typeid(*(value.get()));
+        registry* reg = registry::get(*type);
+        if (reg == NULL) {
+          type = &typeid(T);
+          reg = registry::get(*type);
+        }
+        if (reg != NULL) {
+          if (reg->pushCachedInstance(L, value.get())) {
+            if (static_cast<wrapper_base*>(lua_touserdata(L, -1))->holderKind == holder_boost_intrusive_ptr) {
+              return 1;
+            }
+            lua_pop(L, 1);
+          }
+          wrapper<T*, boost::intrusive_ptr<T> >* w = wrapper<T*, boost::intrusive_ptr<T> >::create(L, *type, reg);
+          w->ref(value.get());
+          w->hold(std::forward<P>(value), holder_boost_intrusive_ptr);
+          w->gc = true;
+          reg->pushMetatable(L);
+          lua_setmetatable(L, -2);
+          reg->cacheInstance(L, w->raw);
+          return 1;
+        }
+      }
+      throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
+    }
+
+  };
+
+  template<typename T>
+  struct converter<boost::intrusive_ptr<T>&> : converter<boost::intrusive_ptr<T> > {};
+
+  template<typename T>
+  struct converter<const boost::intrusive_ptr<T>&> : converter<boost::intrusive_ptr<T> > {};
+
+  // a returned unique_ptr hands its object over to Lua, which deletes it
+  // when the userdata is collected; Lua can not give ownership back
+  template<typename T>
+  struct converter<std::unique_ptr<T> > {
+
+    static const int lua_types = lua_types_of<T>::value;
+
+    static int push(lua_State* L, std::unique_ptr<T>&& value) {
+      if (value.get() == NULL) {
+        lua_pushnil(L);
+        return 1;
+      }
+      converter<T*>::push(L, value.get(), true);
+      value.release();
+      return 1;
+    }
+
+  };
+
   template<typename T>
   struct converter<const T*> {
     
+    static const int lua_types = lua_types_of<T>::value;
+    
     static bool check(lua_State* L, int index) {
       return converter<T>::check(L, index);
     }
@@ -319,6 +504,10 @@ namespace slub {
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
     }
+
+    static const T* getUnchecked(lua_State* L, int index) {
+      return static_cast<const T*>(((wrapper_base*) lua_touserdata(L, index))->raw);
+    }
     
     static int push(lua_State* L, const T* value) {
       return push(L, value, false);
@@ -331,11 +520,21 @@ namespace slub {
       }
       if (registry::isRegisteredType<T>()) {
 //        std::cout << "push, registered" << std::endl;
-        wrapper<const T*>* w = wrapper<const T*>::create(L, typeid(*value));
+        registry* reg = registry::get(typeid(*value));
+        // const and mutable userdata of an object are cached apart
+        if (reg != NULL && reg->pushCachedInstance(L, (void*) value, true)) {
+          if (gc) {
+            static_cast<wrapper<const T*>*>(lua_touserdata(L, -1))->gc = true;
+          }
+          return 1;
+        }
+        wrapper<const T*>* w = wrapper<const T*>::create(L, typeid(*value), reg);
         w->ref(value);
         w->gc = gc;
-        luaL_getmetatable(L, registry::get(typeid(*value))->getTypeName().c_str());
+        w->constant = true;
+        reg->pushMetatable(L);
         lua_setmetatable(L, -2);
+        reg->cacheInstance(L, (void*) value, true);
         return 1;
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
@@ -346,18 +545,24 @@ namespace slub {
   template<typename T>
   struct converter<T&> {
     
+    static const int lua_types = lua_types_of<T>::value;
+    
     static bool check(lua_State* L, int index) {
-      return converter<T>::check(L, index);
+      return converter<T*>::check(L, index);
     }
     
     static T& get(lua_State* L, int index) {
       if (registry::isRegisteredType<T>()) {
 //        std::cout << "get, registered" << std::endl;
-        wrapper<T*>* w = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, index));
+        wrapper<T*>* w = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, index));
         return *w->ref();
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
     }
+
+    static T& getUnchecked(lua_State* L, int index) {
+      return *static_cast<T*>(((wrapper_base*) lua_touserdata(L, index))->raw);
+    }
     
     static int push(lua_State* L, T& value) {
       return push(L, value, false);
@@ -366,11 +571,19 @@ namespace slub {
     static int push(lua_State* L, T& value, bool gc) {
       if (registry::isRegisteredType<T>()) {
 //        std::cout << "push, registered" << std::endl;
-        wrapper<T*>* w = wrapper<T*>::create(L, typeid(value));
+        registry* reg = registry::get(typeid(value));
+        if (reg != NULL && reg->pushCachedInstance(L, (void*) &value)) {
+          if (gc) {
+            static_cast<wrapper<T*>*>(lua_touserdata(L, -1))->gc = true;
+          }
+          return 1;
+        }
+        wrapper<T*>* w = wrapper<T*>::create(L, typeid(value), reg);
         w->ref(&value);
         w->gc = gc;
-        luaL_getmetatable(L, registry::get(typeid(value))->getTypeName().c_str());
+        reg->pushMetatable(L);
         lua_setmetatable(L, -2);
+        reg->cacheInstance(L, (void*) &value);
         return 1;
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
@@ -381,6 +594,8 @@ namespace slub {
   template<typename T>
   struct converter<const T&> {
     
+    static const int lua_types = lua_types_of<T>::value;
+    
     static bool check(lua_State* L, int index) {
       return converter<T>::check(L, index);
     }
@@ -393,6 +608,10 @@ namespace slub {
       }
       throw std::runtime_error(string("trying to use unregistered type ") + string(typeid(T).name()));
     }
+
+    static const T& getUnchecked(lua_State* L, int index) {
+      return *static_cast<const T*>(((wrapper_base*) lua_touserdata(L, index))->raw);
+    }
     
     static int push(lua_State* L, const T& value) {
       return push(L, value, false);
@@ -401,11 +620,21 @@ namespace slub {
     static int push(lua_State* L, const T& value, bool gc) {
       if (registry::isRegisteredType<T>()) {
 //        std::cout << "push, registered" << std::endl;
-        wrapper<const T*>* w = wrapper<const T*>::create(L, typeid(value));
+        registry* reg = registry::get(typeid(value));
+        // const and mutable userdata of an object are cached apart
+        if (reg != NULL && reg->pushCachedInstance(L, (void*) &value, true)) {
+          if (gc) {
+            static_cast<wrapper<const T*>*>(lua_touserdata(L, -1))->gc = true;
+          }
+          return 1;
+        }
+        wrapper<const T*>* w = wrapper<const T*>::create(L, typeid(value), reg);
         w->ref(&value);
         w->gc = gc;
-        luaL_getmetatable(L, registry::get(typeid(value))->getTypeName().c_str());
+        w->constant = true;
+        reg->pushMetatable(L);
         lua_setmetatable(L, -2);
+        reg->cacheInstance(L, (void*) &value, true);
         return 1;
       }
       return 0;
@@ -416,6 +645,8 @@ namespace slub {
   template<>
   struct converter<bool> {
     
+    static const int lua_types = lua_types_boolean;
+    
     static bool check(lua_State* L, int index) {
       return lua_isboolean(L, index);
     }
@@ -424,6 +655,10 @@ namespace slub {
       luaL_checktype(L, index, LUA_TBOOLEAN);
       return lua_toboolean(L, index) != 0; // comparison to silcen MSVC warning
     }
+
+    static bool getUnchecked(lua_State* L, int index) {
+      return lua_toboolean(L, index) != 0;
+    }
     
     static int push(lua_State* L, bool value) {
       lua_pushboolean(L, value);
@@ -435,6 +670,8 @@ namespace slub {
   template<>
   struct converter<int> {
 
+    static const int lua_types = lua_types_number | lua_types_string;
+
     static bool check(lua_State* L, int index) {
       return lua_isnumber(L, index) != 0;
     }
@@ -443,6 +680,10 @@ namespace slub {
       return luaL_checkinteger(L, index);
     }
 
+    static int getUnchecked(lua_State* L, int index) {
+      return (int) lua_tointeger(L, index);
+    }
+
     static int push(lua_State* L, int value) {
       lua_pushinteger(L, value);
       return 1;
@@ -456,6 +697,8 @@ namespace slub {
   template<>
   struct converter<unsigned int> {
     
+    static const int lua_types = lua_types_number | lua_types_string;
+    
     static bool check(lua_State* L, int index) {
       return lua_isnumber(L, index) != 0;
     }
@@ -463,6 +706,10 @@ namespace slub {
     static unsigned int get(lua_State* L, int index) {
       return luaL_checkinteger(L, index);
     }
+
+    static unsigned int getUnchecked(lua_State* L, int index) {
+      return (unsigned int) lua_tointeger(L, index);
+    }
     
     static int push(lua_State* L, unsigned int value) {
       lua_pushinteger(L, value);
@@ -480,6 +727,8 @@ namespace slub {
     template<>
     struct converter<long> {
         
+      static const int lua_types = lua_types_number | lua_types_string;
+        
         static bool check(lua_State* L, int index) {
             return lua_isnumber(L, index) != 0;
         }
@@ -487,6 +736,10 @@ namespace slub {
         static long get(lua_State* L, int index) {
             return luaL_checklong(L, index);
         }
+
+        static long getUnchecked(lua_State* L, int index) {
+            return (long) lua_tointeger(L, index);
+        }
         
         static int push(lua_State* L, long value) {
             lua_pushinteger(L, value);
@@ -501,6 +754,8 @@ namespace slub {
   template<>
   struct converter<unsigned short> {
     
+    static const int lua_types = lua_types_number | lua_types_string;
+    
     static bool check(lua_State* L, int index) {
       return lua_isnumber(L, index) != 0;
     }
@@ -508,6 +763,10 @@ namespace slub {
     static unsigned short get(lua_State* L, int index) {
       return luaL_checkinteger(L, index);
     }
+
+    static unsigned short getUnchecked(lua_State* L, int index) {
+      return (unsigned short) lua_tointeger(L, index);
+    }
     
     static int push(lua_State* L, unsigned short value) {
       lua_pushinteger(L, value);
@@ -522,6 +781,8 @@ namespace slub {
   template<>
   struct converter<unsigned char> {
     
+    static const int lua_types = lua_types_number | lua_types_string;
+    
     static bool check(lua_State* L, int index) {
       return lua_isnumber(L, index) != 0;
     }
@@ -529,6 +790,10 @@ namespace slub {
     static unsigned char get(lua_State* L, int index) {
       return luaL_checkinteger(L, index);
     }
+
+    static unsigned char getUnchecked(lua_State* L, int index) {
+      return (unsigned char) lua_tointeger(L, index);
+    }
     
     static int push(lua_State* L, unsigned char value) {
       lua_pushinteger(L, value);
@@ -543,6 +808,8 @@ namespace slub {
   template<>
   struct converter<double> {
     
+    static const int lua_types = lua_types_number | lua_types_string;
+    
     static bool check(lua_State* L, int index) {
       return lua_isnumber(L, index) != 0;
     }
@@ -550,6 +817,10 @@ namespace slub {
     static double get(lua_State* L, int index) {
       return luaL_checknumber(L, index);
     }
+
+    static double getUnchecked(lua_State* L, int index) {
+      return lua_tonumber(L, index);
+    }
     
     static int push(lua_State* L, double value) {
       lua_pushnumber(L, value);
@@ -564,6 +835,8 @@ namespace slub {
   template<>
   struct converter<char*> {
     
+    static const int lua_types = lua_types_string | lua_types_number;
+    
     static bool check(lua_State* L, int index) {
       return lua_isstring(L, index) != 0;
     }
@@ -571,6 +844,10 @@ namespace slub {
     static const char* get(lua_State* L, int index) {
       return luaL_checkstring(L, index);
     }
+
+    static const char* getUnchecked(lua_State* L, int index) {
+      return lua_tostring(L, index);
+    }
     
     static int push(lua_State* L, char* value) {
       lua_pushstring(L, value);
@@ -582,6 +859,8 @@ namespace slub {
   template<>
   struct converter<const char*> {
     
+    static const int lua_types = lua_types_string | lua_types_number;
+    
     static bool check(lua_State* L, int index) {
       return lua_isstring(L, index) != 0;
     }
@@ -589,6 +868,10 @@ namespace slub {
     static const char* get(lua_State* L, int index) {
       return luaL_checkstring(L, index);
     }
+
+    static const char* getUnchecked(lua_State* L, int index) {
+      return lua_tostring(L, index);
+    }
     
     static int push(lua_State* L, const char* value) {
       lua_pushstring(L, value);
@@ -600,6 +883,8 @@ namespace slub {
   template<>
   struct converter<string> {
     
+    static const int lua_types = lua_types_string | lua_types_number;
+    
     static bool check(lua_State* L, int index) {
       return lua_isstring(L, index) != 0;
     }
@@ -607,6 +892,10 @@ namespace slub {
     static string get(lua_State* L, int index) {
       return luaL_checkstring(L, index);
     }
+
+    static string getUnchecked(lua_State* L, int index) {
+      return lua_tostring(L, index);
+    }
     
     static int push(lua_State* L, const string& value) {
       lua_pushstring(L, value.c_str());
@@ -624,6 +913,8 @@ namespace slub {
   template<>
   struct converter<string*> {
     
+    static const int lua_types = lua_types_string | lua_types_number;
+    
     static bool check(lua_State* L, int index) {
       return lua_isstring(L, index) != 0;
     }
@@ -650,6 +941,8 @@ namespace slub {
   template<>
   struct converter<void*> {
     
+    static const int lua_types = lua_types_userdata | lua_types_lightuserdata;
+    
     static bool check(lua_State* L, int index) {
       return lua_isuserdata(L, index) != 0;
     }
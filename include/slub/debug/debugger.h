@@ -85,10 +85,10 @@ namespace slub {
       
     private:
       
-      map<lua_State*, debugger_callback*> callbacks;
-      map<lua_State*, list<string> > symbol_breakpoints;
-      map<lua_State*, map<string, list<int> > > line_breakpoints;
-      map<lua_State*, bool> single_step;
+      hash_map<lua_State*, debugger_callback*> callbacks;
+      hash_map<lua_State*, small_list<string> > symbol_breakpoints;
+      hash_map<lua_State*, hash_map<string, small_list<int> > > line_breakpoints;
+      hash_map<lua_State*, bool> single_step;
       
       static debugger* getDebuggerFromState(lua_State* state);
       
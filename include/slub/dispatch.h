@@ -0,0 +1,269 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SLUB_DISPATCH_H
+#define SLUB_DISPATCH_H
+
+#include "config.h"
+#include "forward.h"
+#include "slub_lua.h"
+
+#include <vector>
+
+namespace slub {
+
+  template<typename T>
+  struct converter;
+
+  /*
+   bit masks of the Lua types a converter accepts, converters publish them
+   as converter<T>::lua_types. Converters without it are assumed to accept
+   anything.
+   */
+  enum {
+    lua_types_none = 0,
+    lua_types_nil = 1 << (LUA_TNIL + 1),
+    lua_types_boolean = 1 << (LUA_TBOOLEAN + 1),
+    lua_types_lightuserdata = 1 << (LUA_TLIGHTUSERDATA + 1),
+    lua_types_number = 1 << (LUA_TNUMBER + 1),
+    lua_types_string = 1 << (LUA_TSTRING + 1),
+    lua_types_table = 1 << (LUA_TTABLE + 1),
+    lua_types_function = 1 << (LUA_TFUNCTION + 1),
+    lua_types_userdata = 1 << (LUA_TUSERDATA + 1),
+    lua_types_thread = 1 << (LUA_TTHREAD + 1),
+    lua_types_any = ~0
+  };
+
+  inline int lua_type_bit(lua_State* L, int index) {
+    return 1 << (lua_type(L, index) + 1);
+  }
+
+  template<typename T>
+  struct void_type {
+    typedef void type;
+  };
+
+  template<typename T, typename = void>
+  struct lua_types_of {
+    enum { value = lua_types_any };
+  };
+
+  template<typename T>
+  struct lua_types_of<T, typename void_type<decltype(converter<T>::lua_types)>::type> {
+    enum { value = converter<T>::lua_types };
+  };
+
+  // not taken from the Lua stack
+  template<>
+  struct lua_types_of<empty> {
+    enum { value = lua_types_none };
+  };
+
+  template<>
+  struct lua_types_of<lua_State*> {
+    enum { value = lua_types_none };
+  };
+
+  /*
+   number of stack values a bound callable expects and the Lua types it
+   accepts for each of them, a negative arity means unknown
+   */
+  struct signature {
+
+    enum { max_types = 8 };
+
+    signature() : arity(-1) {}
+
+    // leading values are not converted (self, class table) and accept anything
+    explicit signature(int leading) : arity(0) {
+      while (leading-- > 0) {
+        append(lua_types_any);
+      }
+    }
+
+    template<typename... args>
+    static signature of(int leading = 0) {
+      signature result(leading);
+      const int types[] = { lua_types_of<args>::value..., lua_types_none };
+      for (size_t idx = 0; idx < sizeof...(args); ++idx) {
+        if (types[idx] != lua_types_none) {
+          result.append(types[idx]);
+        }
+      }
+      return result;
+    }
+
+    void append(int accepted) {
+      if (arity < max_types) {
+        types[arity] = accepted;
+      }
+      ++arity;
+    }
+
+    /*
+     true if the Lua types of the stack values from index on decide check()
+     once the class of each userdata is known, trivially so if the types are
+     not accepted at all. Strings converted to numbers, light userdata and
+     converters without lua_types depend on the value.
+     */
+    bool decides(lua_State* L, int index) const {
+      if (arity < 0 || arity > max_types) {
+        return false;
+      }
+      for (int idx = index - 1; idx < arity; ++idx) {
+        if ((types[idx] & lua_type_bit(L, idx + 1)) == 0) {
+          return true;
+        }
+      }
+      for (int idx = index - 1; idx < arity; ++idx) {
+        int type = lua_type(L, idx + 1);
+        if (types[idx] == lua_types_any || type == LUA_TLIGHTUSERDATA ||
+            (type == LUA_TSTRING && (types[idx] & lua_types_number) != 0)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    bool accepts(const int* actual) const {
+      int n = arity < max_types ? arity : max_types;
+      for (int idx = 0; idx < n; ++idx) {
+        if ((types[idx] & actual[idx]) == 0) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    int arity;
+    int types[max_types];
+
+  };
+
+  /*
+   overload set bucketed by arity. Candidates of the matching arity are
+   filtered by the Lua types of the arguments, the full check() is only
+   run if more than one candidate remains.
+   */
+  template<typename T>
+  struct overloads {
+
+    void add(T* candidate) {
+      candidates.push_back(candidate);
+      int arity = candidate->sig.arity;
+      if (arity < 0) {
+        unknown.push_back(candidate);
+      }
+      else {
+        if ((int) byArity.size() <= arity) {
+          byArity.resize(arity + 1);
+        }
+        byArity[arity].push_back(candidate);
+      }
+    }
+
+    void add(const overloads& other) {
+      for (typename small_list<T*>::const_iterator idx = other.candidates.begin(); idx != other.candidates.end(); ++idx) {
+        add(*idx);
+      }
+    }
+
+    bool empty() const {
+      return candidates.empty();
+    }
+
+    // true if find() returns the same candidate for all arguments of the same
+    // Lua types and classes as the ones on the stack from index on
+    bool decides(lua_State* L, int index) const {
+      int n = lua_gettop(L);
+      if (!unknown.empty() || n >= (int) byArity.size()) {
+        return false;
+      }
+      const std::vector<T*>& bucket = byArity[n];
+      for (typename std::vector<T*>::const_iterator idx = bucket.begin(); idx != bucket.end(); ++idx) {
+        if (!(*idx)->sig.decides(L, index)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // typed is set if the Lua types of the arguments alone decided
+    T* find(lua_State* L, bool* typed = NULL) const {
+      if (typed != NULL) {
+        *typed = false;
+      }
+      int n = lua_gettop(L);
+      if (n < (int) byArity.size() && !byArity[n].empty()) {
+        const std::vector<T*>& bucket = byArity[n];
+
+        int actual[signature::max_types];
+        for (int idx = 0; idx < n && idx < signature::max_types; ++idx) {
+          actual[idx] = lua_type_bit(L, idx + 1);
+        }
+
+        T* result = NULL;
+        typename std::vector<T*>::const_iterator idx = bucket.begin();
+        for (; idx != bucket.end(); ++idx) {
+          if ((*idx)->sig.accepts(actual)) {
+            if (result != NULL) {
+              break;
+            }
+            result = *idx;
+          }
+        }
+
+        if (idx == bucket.end()) {
+          // the converters still have the final word, e.g. on the class of
+          // a userdata; the call reads the values without checking again
+          if (result != NULL && result->check(L)) {
+            if (typed != NULL) {
+              *typed = true;
+            }
+            return result;
+          }
+        }
+        else {
+          // ambiguous by type, let the converters decide
+          for (idx = bucket.begin(); idx != bucket.end(); ++idx) {
+            if ((*idx)->sig.accepts(actual) && (*idx)->check(L)) {
+              return *idx;
+            }
+          }
+        }
+      }
+
+      for (typename small_list<T*>::const_iterator idx = unknown.begin(); idx != unknown.end(); ++idx) {
+        if ((*idx)->check(L)) {
+          return *idx;
+        }
+      }
+      return NULL;
+    }
+
+    // all candidates in registration order
+    small_list<T*> candidates;
+
+  private:
+
+    std::vector<std::vector<T*> > byArity;
+    small_list<T*> unknown;
+
+  };
+
+}
+
+#endif
@@ -42,7 +42,7 @@ namespace slub {
     }
 
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = converter<F>::get(L, -1);
       return 0;
     }
@@ -63,7 +63,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = converter<F*>::get(L, -1);
       return 0;
     }
@@ -84,7 +84,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = converter<const F*>::get(L, -1);
       return 0;
     }
@@ -105,7 +105,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = converter<boost::shared_ptr<F> >::get(L, -1);
       return 0;
     }
@@ -132,7 +132,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = converter<std::tr1::shared_ptr<F> >::get(L, -1);
       return 0;
     }
@@ -160,7 +160,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       luaL_checktype(L, -1, LUA_TBOOLEAN);
       t->ref()->*m = lua_toboolean(L, -1);
       return 0;
@@ -183,7 +183,7 @@ namespace slub {
     }
 
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = luaL_checkinteger(L, -1);
       return 0;
     }
@@ -205,7 +205,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = luaL_checkinteger(L, -1);
       return 0;
     }
@@ -227,7 +227,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = luaL_checknumber(L, -1);
       return 0;
     }
@@ -249,7 +249,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       t->ref()->*m = luaL_checknumber(L, -1);
       return 0;
     }
@@ -271,7 +271,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       (t->ref()->*setter)(converter<F>::get(L, -1));
       return 0;
     }
@@ -293,7 +293,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       (t->ref()->*setter)(converter<F>::get(L, -1));
       return 0;
     }
@@ -315,7 +315,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       (*setter)(t->ref(), converter<F>::get(L, -1));
       return 0;
     }
@@ -339,7 +339,7 @@ namespace slub {
     }
     
     int set(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
       read_only(t->ref(), converter<F>::get(L, -1));
       return 0;
     }
@@ -44,15 +44,15 @@ namespace slub {
       return lua_typename(state, type());
     }
     
+    // records the key, nothing is looked up until the entry is used
     template<typename indexType>
     table_entry operator[](indexType index) {
       converter<indexType>::push(state, index);
-      lua_pushvalue(state, lua_gettop(state));
-      lua_gettable(state, LUA_GLOBALSINDEX);
-      table_entry result(state);
-      result.key = reference(state);
-      result.parent = reference(state, LUA_GLOBALSINDEX);
-      return result;
+      return table_entry(state, reference_path::extend(state, NULL));
+    }
+
+    table_entry operator[](const key& k) {
+      return table_entry(state, reference_path::extend(state, NULL, k.slot));
     }
     
   protected:
@@ -18,1580 +18,189 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define SLUB_METHOD_H
 
 #include "config.h"
+#include "arguments.h"
 #include "converter.h"
+#include "dispatch.h"
+#include "exception.h"
 #include "registry.h"
 #include "wrapper.h"
 
+/*
+ type and value of a member for clazz::method<...>(name) before C++17
+ */
+#define SLUB_STATIC(m) decltype(m), m
+
 namespace slub {
 
   struct abstract_method {
+    abstract_method() {}
+    abstract_method(const signature& sig) : sig(sig) {}
     virtual bool check(lua_State*) = 0;
     virtual int call(lua_State*) = 0;
+    signature sig;
   };
 
-  template<typename T, typename ret = void, typename arg1 = empty, typename arg2 = empty, typename arg3 = empty, typename arg4 = empty,
-           typename arg5 = empty, typename arg6 = empty, typename arg7 = empty>
+  template<typename T, typename ret = void, typename... args>
   struct method : public abstract_method {
     
-    ret (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, arg7);
+    ret (T::*m)(args...);
     
-    method(ret (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, arg7)) : m(m) {
+    method(ret (T::*m)(args...)) : abstract_method(signature::of<args...>(1)), m(m) {
     }
     
+    // objects pushed as const only take const methods
     bool check(lua_State* L) {
-      return lua_gettop(L) == 8 && converter<arg1>::check(L, -7) && converter<arg2>::check(L, -6) && converter<arg3>::check(L, -5) && converter<arg4>::check(L, -4)
-          && converter<arg5>::check(L, -3) && converter<arg6>::check(L, -2) && converter<arg7>::check(L, -1);
+      return !((wrapper_base*) lua_touserdata(L, 1))->constant && arguments<args...>::check(L, 1);
     }
 
     int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -7), converter<arg2>::get(L, -6), converter<arg3>::get(L, -5), converter<arg4>::get(L, -4),
-                                                  converter<arg5>::get(L, -3), converter<arg6>::get(L, -2), converter<arg7>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T>
-  struct method<T, void, empty, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)();
-    
-    method(void (T::*m)()) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)();
-      return 0;
-    }
-    
-  };
-  
-  template<typename T>
-  struct method<T, void, lua_State*, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(lua_State*);
-    
-    method(void (T::*m)(lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret>
-  struct method<T, ret, empty, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)();
-    
-    method(ret (T::*m)()) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)());
-    }
-    
-  };
-  
-  template<typename T, typename ret>
-  struct method<T, ret, lua_State*, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(lua_State*);
-    
-    method(ret (T::*m)(lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1>
-  struct method<T, void, arg1, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1);
-    
-    method(void (T::*m)(arg1)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1>
-  struct method<T, void, arg1, lua_State*, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, lua_State*);
-    
-    method(void (T::*m)(arg1, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1>
-  struct method<T, ret, arg1, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1);
-    
-    method(ret (T::*m)(arg1)) : m(m) {
+      // callMethod found this method in the registry of self's own wrapper
+      return invoke(L, converter<T*>::getUnchecked(L, 1), typename arguments<args...>::all());
     }
 
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -1)));
+  private:
+
+    template<int... is>
+    int invoke(lua_State* L, T* obj, indices<is...>) {
+      return result<ret>::method(L, obj, m, arguments<args...>::template get<is>(L)...);
     }
     
   };
   
-  template<typename T, typename ret, typename arg1>
-  struct method<T, ret, arg1, lua_State*, empty, empty, empty, empty, empty> : public abstract_method {
+  template<typename T, typename ret = void, typename... args>
+  struct const_method : public abstract_method {
     
-    ret (T::*m)(arg1, lua_State*);
+    ret (T::*m)(args...) const;
     
-    method(ret (T::*m)(arg1, lua_State*)) : m(m) {
+    const_method(ret (T::*m)(args...) const) : abstract_method(signature::of<args...>(1)), m(m) {
     }
     
     bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2>
-  struct method<T, void, arg1, arg2, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2);
-    
-    method(void (T::*m)(arg1, arg2)) : m(m) {
+      return arguments<args...>::check(L, 1);
     }
 
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
     int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1));
-      return 0;
+      // callMethod found this method in the registry of self's own wrapper
+      return invoke(L, converter<T*>::getUnchecked(L, 1), typename arguments<args...>::all());
     }
-    
-  };
 
-  template<typename T, typename arg1, typename arg2>
-  struct method<T, void, arg1, arg2, lua_State*, empty, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, lua_State*);
-    
-    method(void (T::*m)(arg1, arg2, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2>
-  struct method<T, ret, arg1, arg2, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2);
-    
-    method(ret (T::*m)(arg1, arg2)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2>
-  struct method<T, ret, arg1, arg2, lua_State*, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, lua_State*);
-    
-    method(ret (T::*m)(arg1, arg2, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3>
-  struct method<T, void, arg1, arg2, arg3, empty, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3);
-    
-    method(void (T::*m)(arg1, arg2, arg3)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3>
-  struct method<T, void, arg1, arg2, arg3, lua_State*, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, lua_State*);
-    
-    method(void (T::*m)(arg1, arg2, arg3, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3>
-  struct method<T, ret, arg1, arg2, arg3, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3);
-    
-    method(ret (T::*m)(arg1, arg2, arg3)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1)));
+  private:
+
+    template<int... is>
+    int invoke(lua_State* L, T* obj, indices<is...>) {
+      return result<ret>::method(L, obj, m, arguments<args...>::template get<is>(L)...);
     }
     
   };
   
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3>
-  struct method<T, ret, arg1, arg2, arg3, lua_State*, empty, empty, empty> : public abstract_method {
+  template<typename T, typename ret = void, typename... args>
+  struct func_method : public abstract_method {
     
-    ret (T::*m)(arg1, arg2, arg3, lua_State*);
+    ret (*m)(T*, args...);
     
-    method(ret (T::*m)(arg1, arg2, arg3, lua_State*)) : m(m) {
+    func_method(ret (*m)(T*, args...)) : abstract_method(signature::of<args...>(1)), m(m) {
     }
     
+    // objects pushed as const only take const methods
     bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
+      return !((wrapper_base*) lua_touserdata(L, 1))->constant && arguments<args...>::check(L, 1);
     }
-    
+
     int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct method<T, void, arg1, arg2, arg3, arg4, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, arg4);
-    
-    method(void (T::*m)(arg1, arg2, arg3, arg4)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
+      // callMethod found this method in the registry of self's own wrapper
+      return invoke(L, converter<T*>::getUnchecked(L, 1), typename arguments<args...>::all());
     }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1));
-      return 0;
+
+  private:
+
+    template<int... is>
+    int invoke(lua_State* L, T* obj, indices<is...>) {
+      return result<ret>::function(L, m, obj, arguments<args...>::template get<is>(L)...);
     }
     
   };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct method<T, void, arg1, arg2, arg3, arg4, lua_State*, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, arg4, lua_State*);
-    
-    method(void (T::*m)(arg1, arg2, arg3, arg4, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
+
+  // raises the Lua error for a call matching no bound signature, self has been checked
+  inline int overload_not_found(lua_State* L, const char* methodName) {
+    wrapper_base* w = (wrapper_base*) lua_touserdata(L, 1);
+    string s = w->reg()->getTypeName() +"."+ methodName +"(";
+    for (int idx = 2; idx <= lua_gettop(L); ++idx) {
+      if (idx > 2) {
+        s += ", ";
+      }
+      s += luaL_typename(L, idx);
+    }
+    s += ")";
+    OverloadNotFoundException e(s);
+    lua_pushstring(L, e.what());
+    return lua_error(L);
+  }
+
+  /*
+   a method known at compile time, call is a lua_CFunction taking the method
+   name as upvalue and neither consults the registry nor dispatches virtually
+   */
+  template<typename M, M m>
+  struct static_method;
+
+  template<typename T, typename ret, typename... args, ret (T::*m)(args...)>
+  struct static_method<ret (T::*)(args...), m> {
+
+    static int call(lua_State* L) {
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
+      if (!arguments<args...>::check(L, 1)) {
+        return overload_not_found(L, lua_tostring(L, lua_upvalueindex(1)));
+      }
+      return invoke(L, t->ref(), typename arguments<args...>::all());
     }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1), L);
-      return 0;
+
+  private:
+
+    template<int... is>
+    static int invoke(lua_State* L, T* obj, indices<is...>) {
+      return result<ret>::method(L, obj, m, arguments<args...>::template get<is>(L)...);
     }
-    
+
   };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct method<T, ret, arg1, arg2, arg3, arg4, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3, arg4);
-    
-    method(ret (T::*m)(arg1, arg2, arg3, arg4)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
+
+  template<typename T, typename ret, typename... args, ret (T::*m)(args...) const>
+  struct static_method<ret (T::*)(args...) const, m> {
+
+    static int call(lua_State* L) {
       wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct method<T, ret, arg1, arg2, arg3, arg4, lua_State*, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3, arg4, lua_State*);
-    
-    method(ret (T::*m)(arg1, arg2, arg3, arg4, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
+      if (!arguments<args...>::check(L, 1)) {
+        return overload_not_found(L, lua_tostring(L, lua_upvalueindex(1)));
+      }
+      return invoke(L, t->ref(), typename arguments<args...>::all());
     }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1), L));
+
+  private:
+
+    template<int... is>
+    static int invoke(lua_State* L, T* obj, indices<is...>) {
+      return result<ret>::method(L, obj, m, arguments<args...>::template get<is>(L)...);
     }
-    
+
   };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-  struct method<T, void, arg1, arg2, arg3, arg4, arg5, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, arg4, arg5);
-    
-    method(void (T::*m)(arg1, arg2, arg3, arg4, arg5)) : m(m) {
+
+  template<typename T, typename ret, typename... args, ret (*m)(T*, args...)>
+  struct static_method<ret (*)(T*, args...), m> {
+
+    static int call(lua_State* L) {
+      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T*>::checkudata(L, 1));
+      if (!arguments<args...>::check(L, 1)) {
+        return overload_not_found(L, lua_tostring(L, lua_upvalueindex(1)));
+      }
+      return invoke(L, t->ref(), typename arguments<args...>::all());
     }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 6 && converter<arg1>::check(L, -5) && converter<arg2>::check(L, -4) && converter<arg3>::check(L, -3) && converter<arg4>::check(L, -2)
-           && converter<arg5>::check(L, -1);
+
+  private:
+
+    template<int... is>
+    static int invoke(lua_State* L, T* obj, indices<is...>) {
+      return result<ret>::function(L, m, obj, arguments<args...>::template get<is>(L)...);
     }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -5), converter<arg2>::get(L, -4), converter<arg3>::get(L, -3), converter<arg4>::get(L, -2), converter<arg5>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-  struct method<T, void, arg1, arg2, arg3, arg4, arg5, lua_State*, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, arg4, arg5, lua_State*);
-    
-    method(void (T::*m)(arg1, arg2, arg3, arg4, arg5, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 6 && converter<arg1>::check(L, -5) && converter<arg2>::check(L, -4) && converter<arg3>::check(L, -3) && converter<arg4>::check(L, -2)
-      && converter<arg5>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -5), converter<arg2>::get(L, -4), converter<arg3>::get(L, -3), converter<arg4>::get(L, -2), converter<arg5>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-  struct method<T, ret, arg1, arg2, arg3, arg4, arg5, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3, arg4, arg5);
-    
-    method(ret (T::*m)(arg1, arg2, arg3, arg4, arg5)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 6 && converter<arg1>::check(L, -5) && converter<arg2>::check(L, -4) && converter<arg3>::check(L, -3)
-      && converter<arg4>::check(L, -2) && converter<arg5>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -5), converter<arg2>::get(L, -4), converter<arg3>::get(L, -3),
-                                                  converter<arg4>::get(L, -2), converter<arg5>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-  struct method<T, ret, arg1, arg2, arg3, arg4, arg5, lua_State*, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3, arg4, arg5, lua_State*);
-    
-    method(ret (T::*m)(arg1, arg2, arg3, arg4, arg5, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 6 && converter<arg1>::check(L, -5) && converter<arg2>::check(L, -4) && converter<arg3>::check(L, -3)
-      && converter<arg4>::check(L, -2) && converter<arg5>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -5), converter<arg2>::get(L, -4), converter<arg3>::get(L, -3),
-                                                  converter<arg4>::get(L, -2), converter<arg5>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-  struct method<T, void, arg1, arg2, arg3, arg4, arg5, arg6, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6);
-    
-    method(void (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 7 && converter<arg1>::check(L, -6) && converter<arg2>::check(L, -5) && converter<arg3>::check(L, -4)
-          && converter<arg4>::check(L, -3) && converter<arg5>::check(L, -2) && converter<arg6>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -6), converter<arg2>::get(L, -5), converter<arg3>::get(L, -4), converter<arg4>::get(L, -3),
-                   converter<arg5>::get(L, -2), converter<arg6>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-  struct method<T, void, arg1, arg2, arg3, arg4, arg5, arg6, lua_State*> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, lua_State*);
-    
-    method(void (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 7 && converter<arg1>::check(L, -6) && converter<arg2>::check(L, -5) && converter<arg3>::check(L, -4)
-      && converter<arg4>::check(L, -3) && converter<arg5>::check(L, -2) && converter<arg6>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -6), converter<arg2>::get(L, -5), converter<arg3>::get(L, -4), converter<arg4>::get(L, -3),
-                   converter<arg5>::get(L, -2), converter<arg6>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-  struct method<T, ret, arg1, arg2, arg3, arg4, arg5, arg6, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6);
-    
-    method(ret (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 7 && converter<arg1>::check(L, -6) && converter<arg2>::check(L, -5) && converter<arg3>::check(L, -4)
-          && converter<arg4>::check(L, -3) && converter<arg5>::check(L, -2) && converter<arg6>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -6), converter<arg2>::get(L, -5), converter<arg3>::get(L, -4),
-                                                  converter<arg4>::get(L, -3), converter<arg5>::get(L, -2), converter<arg6>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-  struct method<T, ret, arg1, arg2, arg3, arg4, arg5, arg6, lua_State*> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, lua_State*);
-    
-    method(ret (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 7 && converter<arg1>::check(L, -6) && converter<arg2>::check(L, -5) && converter<arg3>::check(L, -4)
-      && converter<arg4>::check(L, -3) && converter<arg5>::check(L, -2) && converter<arg6>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -6), converter<arg2>::get(L, -5), converter<arg3>::get(L, -4),
-                                                  converter<arg4>::get(L, -3), converter<arg5>::get(L, -2), converter<arg6>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-  struct method<T, void, arg1, arg2, arg3, arg4, arg5, arg6, arg7> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, arg7);
-    
-    method(void (T::*m)(arg1, arg2, arg3, arg4, arg5, arg6, arg7)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 8 && converter<arg1>::check(L, -7) && converter<arg2>::check(L, -6) && converter<arg3>::check(L, -5)
-          && converter<arg4>::check(L, -4) && converter<arg5>::check(L, -3) && converter<arg6>::check(L, -2) && converter<arg7>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -7), converter<arg2>::get(L, -6), converter<arg3>::get(L, -5), converter<arg4>::get(L, -4),
-                   converter<arg5>::get(L, -3), converter<arg6>::get(L, -2), converter<arg7>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret = void, typename arg1 = empty, typename arg2 = empty, typename arg3 = empty, typename arg4 = empty>
-  struct const_method : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3, arg4) const;
-    
-    const_method(ret (T::*m)(arg1, arg2, arg3, arg4) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T>
-  struct const_method<T, void, empty, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)() const;
-    
-    const_method(void (T::*m)() const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)();
-      return 0;
-    }
-    
-  };
-  
-  template<typename T>
-  struct const_method<T, void, lua_State*, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(lua_State*) const;
-    
-    const_method(void (T::*m)(lua_State*) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret>
-  struct const_method<T, ret, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)() const;
-    
-    const_method(ret (T::*m)() const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)());
-    }
-    
-  };
-  
-  template<typename T, typename ret>
-  struct const_method<T, ret, lua_State*, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(lua_State*) const;
-    
-    const_method(ret (T::*m)(lua_State*) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1>
-  struct const_method<T, void, arg1, empty, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1) const;
-    
-    const_method(void (T::*m)(arg1) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1>
-  struct const_method<T, void, arg1, lua_State*, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, lua_State*) const;
-    
-    const_method(void (T::*m)(arg1, lua_State*) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1>
-  struct const_method<T, ret, arg1, empty, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1) const;
-    
-    const_method(ret (T::*m)(arg1) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1>
-  struct const_method<T, ret, arg1, lua_State*, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, lua_State*) const;
-    
-    const_method(ret (T::*m)(arg1, lua_State*) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2>
-  struct const_method<T, void, arg1, arg2, empty, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2) const;
-    
-    const_method(void (T::*m)(arg1, arg2) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1));
-      return 0;
-    }
-    
-  };
 
-  template<typename T, typename arg1, typename arg2>
-  struct const_method<T, void, arg1, arg2, lua_State*, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, lua_State*) const;
-    
-    const_method(void (T::*m)(arg1, arg2, lua_State*) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2>
-  struct const_method<T, ret, arg1, arg2, empty, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2) const;
-    
-    const_method(ret (T::*m)(arg1, arg2) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2>
-  struct const_method<T, ret, arg1, arg2, lua_State*, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, lua_State*) const;
-    
-    const_method(ret (T::*m)(arg1, arg2, lua_State*) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -2), converter<arg2>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3>
-  struct const_method<T, void, arg1, arg2, arg3, empty> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3) const;
-    
-    const_method(void (T::*m)(arg1, arg2, arg3) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3>
-  struct const_method<T, void, arg1, arg2, arg3, lua_State*> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, lua_State*) const;
-    
-    const_method(void (T::*m)(arg1, arg2, arg3, lua_State*) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3>
-  struct const_method<T, ret, arg1, arg2, arg3, empty> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3) const;
-    
-    const_method(ret (T::*m)(arg1, arg2, arg3) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3>
-  struct const_method<T, ret, arg1, arg2, arg3, lua_State*> : public abstract_method {
-    
-    ret (T::*m)(arg1, arg2, arg3, lua_State*) const;
-    
-    const_method(ret (T::*m)(arg1, arg2, arg3, lua_State*) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (t->ref()->*m)(converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct const_method<T, void, arg1, arg2, arg3, arg4> : public abstract_method {
-    
-    void (T::*m)(arg1, arg2, arg3, arg4) const;
-    
-    const_method(void (T::*m)(arg1, arg2, arg3, arg4) const) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (t->ref()->*m)(converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret = void, typename arg1 = empty, typename arg2 = empty, typename arg3 = empty, typename arg4 = empty,
-           typename arg5 = empty, typename arg6 = empty, typename arg7 = empty>
-  struct func_method : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, arg7);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, arg7)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 8 && converter<arg1>::check(L, -7) && converter<arg2>::check(L, -6) && converter<arg3>::check(L, -5) && converter<arg4>::check(L, -4)
-          && converter<arg5>::check(L, -3) && converter<arg6>::check(L, -2) && converter<arg7>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -7), converter<arg2>::get(L, -6), converter<arg3>::get(L, -5), converter<arg4>::get(L, -4),
-                                          converter<arg5>::get(L, -3), converter<arg6>::get(L, -2), converter<arg7>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T>
-  struct func_method<T, void, empty, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*);
-    
-    func_method(void (*m)(T*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref());
-      return 0;
-    }
-    
-  };
-  
-  template<typename T>
-  struct func_method<T, void, lua_State*, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, lua_State*);
-    
-    func_method(void (*m)(T*, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret>
-  struct func_method<T, ret, empty, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*);
-    
-    func_method(ret (*m)(T*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref()));
-    }
-    
-  };
-  
-  template<typename T, typename ret>
-  struct func_method<T, ret, lua_State*, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, lua_State*);
-    
-    func_method(ret (*m)(T*, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 1;
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1>
-  struct func_method<T, void, arg1, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1);
-    
-    func_method(void (*m)(T*, arg1)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1>
-  struct func_method<T, void, arg1, lua_State*, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, lua_State*);
-    
-    func_method(void (*m)(T*, arg1, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1>
-  struct func_method<T, ret, arg1, empty, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1);
-    
-    func_method(ret (*m)(T*, arg1)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1>
-  struct func_method<T, ret, arg1, lua_State*, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, lua_State*);
-    
-    func_method(ret (*m)(T*, arg1, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 2 && converter<arg1>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2>
-  struct func_method<T, void, arg1, arg2, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2);
-    
-    func_method(void (*m)(T*, arg1, arg2)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -2), converter<arg2>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2>
-  struct func_method<T, void, arg1, arg2, lua_State*, empty, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, lua_State*);
-    
-    func_method(void (*m)(T*, arg1, arg2, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -2), converter<arg2>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2>
-  struct func_method<T, ret, arg1, arg2, empty, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2);
-    
-    func_method(ret (*m)(T*, arg1, arg2)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -2), converter<arg2>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2>
-  struct func_method<T, ret, arg1, arg2, lua_State*, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, lua_State*);
-    
-    func_method(ret (*m)(T*, arg1, arg2, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 3 && converter<arg1>::check(L, -2) && converter<arg2>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -2), converter<arg2>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3>
-  struct func_method<T, void, arg1, arg2, arg3, empty, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3>
-  struct func_method<T, void, arg1, arg2, arg3, lua_State*, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3, lua_State*);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3>
-  struct func_method<T, ret, arg1, arg2, arg3, empty, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3>
-  struct func_method<T, ret, arg1, arg2, arg3, lua_State*, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3, lua_State*);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 4 && converter<arg1>::check(L, -3) && converter<arg2>::check(L, -2) && converter<arg3>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -3), converter<arg2>::get(L, -2), converter<arg3>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct func_method<T, void, arg1, arg2, arg3, arg4, empty, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3, arg4);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3, arg4)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct func_method<T, void, arg1, arg2, arg3, arg4, lua_State*, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3, arg4, lua_State*);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3, arg4, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2) && converter<arg4>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2), converter<arg4>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct func_method<T, ret, arg1, arg2, arg3, arg4, empty, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3, arg4);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3, arg4)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2)
-          && converter<arg4>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2),
-                                          converter<arg4>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4>
-  struct func_method<T, ret, arg1, arg2, arg3, arg4, lua_State*, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3, arg4, lua_State*);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3, arg4, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 5 && converter<arg1>::check(L, -4) && converter<arg2>::check(L, -3) && converter<arg3>::check(L, -2)
-      && converter<arg4>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -4), converter<arg2>::get(L, -3), converter<arg3>::get(L, -2),
-                                          converter<arg4>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-  struct func_method<T, void, arg1, arg2, arg3, arg4, arg5, empty, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3, arg4, arg5);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3, arg4, arg5)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 6 && converter<arg1>::check(L, -5) && converter<arg2>::check(L, -4) && converter<arg3>::check(L, -3)
-          && converter<arg4>::check(L, -2) && converter<arg5>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -5), converter<arg2>::get(L, -4), converter<arg3>::get(L, -3), converter<arg4>::get(L, -2),
-           converter<arg5>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-  struct func_method<T, void, arg1, arg2, arg3, arg4, arg5, lua_State*, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3, arg4, arg5, lua_State*);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3, arg4, arg5, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 6 && converter<arg1>::check(L, -5) && converter<arg2>::check(L, -4) && converter<arg3>::check(L, -3)
-      && converter<arg4>::check(L, -2) && converter<arg5>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -5), converter<arg2>::get(L, -4), converter<arg3>::get(L, -3), converter<arg4>::get(L, -2),
-           converter<arg5>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-  struct func_method<T, ret, arg1, arg2, arg3, arg4, arg5, empty, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3, arg4, arg5);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3, arg4, arg5)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 6 && converter<arg1>::check(L, -5) && converter<arg2>::check(L, -4) && converter<arg3>::check(L, -3)
-          && converter<arg4>::check(L, -2) && converter<arg5>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -5), converter<arg2>::get(L, -4), converter<arg3>::get(L, -3),
-                                          converter<arg4>::get(L, -2), converter<arg5>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-  struct func_method<T, ret, arg1, arg2, arg3, arg4, arg5, lua_State*, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, lua_State*);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 6 && converter<arg1>::check(L, -5) && converter<arg2>::check(L, -4) && converter<arg3>::check(L, -3)
-      && converter<arg4>::check(L, -2) && converter<arg5>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -5), converter<arg2>::get(L, -4), converter<arg3>::get(L, -3),
-                                          converter<arg4>::get(L, -2), converter<arg5>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-  struct func_method<T, void, arg1, arg2, arg3, arg4, arg5, arg6, empty> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 7 && converter<arg1>::check(L, -6) && converter<arg2>::check(L, -5) && converter<arg3>::check(L, -4)
-          && converter<arg4>::check(L, -3) && converter<arg5>::check(L, -2) && converter<arg6>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -6), converter<arg2>::get(L, -5), converter<arg3>::get(L, -4), converter<arg4>::get(L, -3),
-           converter<arg5>::get(L, -2), converter<arg6>::get(L, -1));
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-  struct func_method<T, void, arg1, arg2, arg3, arg4, arg5, arg6, lua_State*> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, lua_State*);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 7 && converter<arg1>::check(L, -6) && converter<arg2>::check(L, -5) && converter<arg3>::check(L, -4)
-      && converter<arg4>::check(L, -3) && converter<arg5>::check(L, -2) && converter<arg6>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -6), converter<arg2>::get(L, -5), converter<arg3>::get(L, -4), converter<arg4>::get(L, -3),
-           converter<arg5>::get(L, -2), converter<arg6>::get(L, -1), L);
-      return 0;
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-  struct func_method<T, ret, arg1, arg2, arg3, arg4, arg5, arg6, empty> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 7 && converter<arg1>::check(L, -6) && converter<arg2>::check(L, -5) && converter<arg3>::check(L, -4)
-      && converter<arg4>::check(L, -3) && converter<arg5>::check(L, -2) && converter<arg6>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -6), converter<arg2>::get(L, -5), converter<arg3>::get(L, -4),
-                                          converter<arg4>::get(L, -3), converter<arg5>::get(L, -2), converter<arg6>::get(L, -1)));
-    }
-    
-  };
-  
-  template<typename T, typename ret, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-  struct func_method<T, ret, arg1, arg2, arg3, arg4, arg5, arg6, lua_State*> : public abstract_method {
-    
-    ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, lua_State*);
-    
-    func_method(ret (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, lua_State*)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 7 && converter<arg1>::check(L, -6) && converter<arg2>::check(L, -5) && converter<arg3>::check(L, -4)
-      && converter<arg4>::check(L, -3) && converter<arg5>::check(L, -2) && converter<arg6>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      return converter<ret>::push(L, (*m)(t->ref(), converter<arg1>::get(L, -6), converter<arg2>::get(L, -5), converter<arg3>::get(L, -4),
-                                          converter<arg4>::get(L, -3), converter<arg5>::get(L, -2), converter<arg6>::get(L, -1), L));
-    }
-    
-  };
-  
-  template<typename T, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-  struct func_method<T, void, arg1, arg2, arg3, arg4, arg5, arg6, arg7> : public abstract_method {
-    
-    void (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, arg7);
-    
-    func_method(void (*m)(T*, arg1, arg2, arg3, arg4, arg5, arg6, arg7)) : m(m) {
-    }
-    
-    bool check(lua_State* L) {
-      return lua_gettop(L) == 8 && converter<arg1>::check(L, -7) && converter<arg2>::check(L, -6) && converter<arg3>::check(L, -5)
-          && converter<arg4>::check(L, -4) && converter<arg5>::check(L, -3) && converter<arg6>::check(L, -2) && converter<arg7>::check(L, -1);
-    }
-    
-    int call(lua_State* L) {
-      wrapper<T*>* t = static_cast<wrapper<T*>*>(converter<T>::checkudata(L, 1));
-      (*m)(t->ref(), converter<arg1>::get(L, -7), converter<arg2>::get(L, -6), converter<arg3>::get(L, -5), converter<arg4>::get(L, -4),
-           converter<arg5>::get(L, -3), converter<arg6>::get(L, -2), converter<arg7>::get(L, -1));
-      return 0;
-    }
-    
   };
   
 }
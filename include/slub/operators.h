@@ -18,7 +18,9 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define SLUB_OPERATORS_H
 
 #include "slub_lua.h"
+#include "arguments.h"
 #include "converter.h"
+#include "dispatch.h"
 
 #include <sstream>
 
@@ -26,14 +28,22 @@ namespace slub {
 
   struct abstract_operator {
 
+    abstract_operator() {}
+    abstract_operator(const signature& sig) : sig(sig) {}
+
     virtual bool check(lua_State* L) = 0;
     virtual int op(lua_State* L) = 0;
 
+    signature sig;
+
   };
 
   template<typename T, typename F = empty>
   struct operator_ : public abstract_operator {
 
+    operator_() : abstract_operator(signature::of<T, F>()) {
+    }
+
     bool check(lua_State* L) {
       return lua_gettop(L) == 2 && converter<T>::check(L, 1) && converter<F>::check(L, -1);
     }
@@ -43,6 +53,9 @@ namespace slub {
   template<typename T>
   struct operator_<T, empty> : public abstract_operator {
     
+    operator_() : abstract_operator(signature::of<T>()) {
+    }
+
     bool check(lua_State* L) {
       return lua_gettop(L) == 1 && converter<T>::check(L, 1);
     }
@@ -53,7 +66,7 @@ namespace slub {
   struct eq_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<bool>::push(L, *converter<T*>::get(L, 1) == converter<F>::get(L, -1));
+      return converter<bool>::push(L, *converter<T*>::getUnchecked(L, 1) == argument<F>::get(L, -1));
     }
     
   };
@@ -62,7 +75,7 @@ namespace slub {
   struct lt_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<bool>::push(L, *converter<T*>::get(L, 1) < converter<F>::get(L, -1));
+      return converter<bool>::push(L, *converter<T*>::getUnchecked(L, 1) < argument<F>::get(L, -1));
     }
     
   };
@@ -71,7 +84,7 @@ namespace slub {
   struct le_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<bool>::push(L, *converter<T*>::get(L, 1) <= converter<F>::get(L, -1));
+      return converter<bool>::push(L, *converter<T*>::getUnchecked(L, 1) <= argument<F>::get(L, -1));
     }
     
   };
@@ -81,7 +94,7 @@ namespace slub {
     
     int op(lua_State* L) {
       std::stringstream s;
-      s << *converter<T*>::get(L, 1);
+      s << *converter<T*>::getUnchecked(L, 1);
       lua_pushstring(L, s.str().c_str());
       return 1;
     }
@@ -102,7 +115,7 @@ namespace slub {
   struct add_operator : public operator_<T, F> {
 
     int op(lua_State* L) {
-      return converter<R>::push(L, *converter<T*>::get(L, 1) + converter<F>::get(L, -1));
+      return converter<R>::push(L, *converter<T*>::getUnchecked(L, 1) + argument<F>::get(L, -1));
     }
 
   };
@@ -111,7 +124,7 @@ namespace slub {
   struct sub_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<R>::push(L, *converter<T*>::get(L, 1) - converter<F>::get(L, -1));
+      return converter<R>::push(L, *converter<T*>::getUnchecked(L, 1) - argument<F>::get(L, -1));
     }
            
   };
@@ -120,7 +133,7 @@ namespace slub {
   struct mul_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<R>::push(L, *converter<T*>::get(L, 1) * converter<F>::get(L, -1));
+      return converter<R>::push(L, *converter<T*>::getUnchecked(L, 1) * argument<F>::get(L, -1));
     }
            
   };
@@ -129,7 +142,7 @@ namespace slub {
   struct div_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<R>::push(L, *converter<T*>::get(L, 1) / converter<F>::get(L, -1));
+      return converter<R>::push(L, *converter<T*>::getUnchecked(L, 1) / argument<F>::get(L, -1));
     }
            
   };
@@ -138,7 +151,7 @@ namespace slub {
   struct mod_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<R>::push(L, *converter<T*>::get(L, 1) % converter<F>::get(L, -1));
+      return converter<R>::push(L, *converter<T*>::getUnchecked(L, 1) % argument<F>::get(L, -1));
     }
            
   };
@@ -147,7 +160,7 @@ namespace slub {
   struct pow_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<R>::push(L, *converter<T*>::get(L, 1) ^ converter<F>::get(L, -1));
+      return converter<R>::push(L, *converter<T*>::getUnchecked(L, 1) ^ argument<F>::get(L, -1));
     }
            
   };
@@ -155,12 +168,17 @@ namespace slub {
   template<typename T, typename R>
   struct unm_operator : public operator_<T, empty> {
     
+    // Lua passes the operand twice
+    unm_operator() {
+      this->sig.append(lua_types_any);
+    }
+
     bool check(lua_State* L) {
       return lua_gettop(L) == 2 && converter<T>::check(L, 1);
     }
 
     int op(lua_State* L) {
-      return converter<R>::push(L, -(*converter<T*>::get(L, 1)));
+      return converter<R>::push(L, -(*converter<T*>::getUnchecked(L, 1)));
     }
     
   };
@@ -169,7 +187,7 @@ namespace slub {
   struct index_operator : public operator_<T, F> {
     
     int op(lua_State* L) {
-      return converter<R>::push(L, (*converter<T*>::get(L, 1)).operator[](converter<F>::get(L, -1)));
+      return converter<R>::push(L, (*converter<T*>::getUnchecked(L, 1)).operator[](argument<F>::get(L, -1)));
     }
            
   };
@@ -67,133 +67,14 @@ namespace slub {
       return result;
     }
     
-    package_& function(const string& name, void (*f)()) {
+    template<typename R, typename... args>
+    package_& function(const string& name, R (*f)(args...)) {
       lua_rawgeti(state, LUA_REGISTRYINDEX, table);
       slub::function(state, name, f, this->name, lua_gettop(state));
       lua_pop(state, 1);
       return *this;
     }
     
-    template<typename arg1>
-    package_& function(const string& name, void (*f)(arg1)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<arg1>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2>
-    package_& function(const string& name, void (*f)(arg1, arg2)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<arg1, arg2>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3>
-    package_& function(const string& name, void (*f)(arg1, arg2, arg3)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<arg1, arg2, arg3>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4>
-    package_& function(const string& name, void (*f)(arg1, arg2, arg3, arg4)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<arg1, arg2, arg3, arg4>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-    package_& function(const string& name, void (*f)(arg1, arg2, arg3, arg4, arg5)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<arg1, arg2, arg3, arg4, arg5>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-    package_& function(const string& name, void (*f)(arg1, arg2, arg3, arg4, arg5, arg6)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<arg1, arg2, arg3, arg4, arg5, arg6>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-    package_& function(const string& name, void (*f)(arg1, arg2, arg3, arg4, arg5, arg6, arg7)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<arg1, arg2, arg3, arg4, arg5, arg6, arg7>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename R>
-    package_& function(const string& name, R (*f)()) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<R>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename R, typename arg1>
-    package_& function(const string& name, R (*f)(arg1)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<R, arg1>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2>
-    package_& function(const string& name, R (*f)(arg1, arg2)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<R, arg1, arg2>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3>
-    package_& function(const string& name, R (*f)(arg1, arg2, arg3)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<R, arg1, arg2, arg3>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3, typename arg4>
-    package_& function(const string& name, R (*f)(arg1, arg2, arg3, arg4)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<R, arg1, arg2, arg3, arg4>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5>
-    package_& function(const string& name, R (*f)(arg1, arg2, arg3, arg4, arg5)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<R, arg1, arg2, arg3, arg4, arg5>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6>
-    package_& function(const string& name, R (*f)(arg1, arg2, arg3, arg4, arg5, arg6)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<R, arg1, arg2, arg3, arg4, arg5, arg6>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
-    template<typename R, typename arg1, typename arg2, typename arg3, typename arg4, typename arg5, typename arg6, typename arg7>
-    package_& function(const string& name, R (*f)(arg1, arg2, arg3, arg4, arg5, arg6, arg7)) {
-      lua_rawgeti(state, LUA_REGISTRYINDEX, table);
-      slub::function<R, arg1, arg2, arg3, arg4, arg5, arg6, arg7>(state, name, f, this->name, lua_gettop(state));
-      lua_pop(state, 1);
-      return *this;
-    }
-    
     template<typename T>
     package_& enumerated(const string& constantName, const T& value) {
       constant<int>(constantName, value);
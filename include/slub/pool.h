@@ -0,0 +1,140 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SLUB_POOL_H
+#define SLUB_POOL_H
+
+#include "constructor.h"
+#include "wrapper.h"
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace slub {
+
+  struct pool_stats {
+    pool_stats() : live(0), peak(0), reserved(0), allocations(0) {}
+
+    size_t live;  // instances currently handed out
+    size_t peak;  // highest number of live instances so far
+    size_t reserved;  // instances the slabs have room for
+    size_t allocations;  // allocations served since startup
+  };
+
+  // free list of fixed size slots for T, grown a slab at a time and only
+  // given back to the system at exit
+  template<typename T, size_t slabSize = 64>
+  struct object_pool {
+
+    static void* allocate() {
+      object_pool& p = instance();
+      if (p.free == NULL) {
+        p.grow();
+      }
+      slot* s = p.free;
+      p.free = s->next;
+      ++p.stats_.allocations;
+      if (++p.stats_.live > p.stats_.peak) {
+        p.stats_.peak = p.stats_.live;
+      }
+      return &s->storage;
+    }
+
+    static void deallocate(void* storage) {
+      object_pool& p = instance();
+      slot* s = static_cast<slot*>(storage);
+      s->next = p.free;
+      p.free = s;
+      --p.stats_.live;
+    }
+
+    static const pool_stats& stats() {
+      return instance().stats_;
+    }
+
+  private:
+
+    union slot {
+      slot* next;
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    object_pool() : free(NULL) {}
+
+    ~object_pool() {
+      for (size_t idx = 0; idx < slabs.size(); ++idx) {
+        delete[] slabs[idx];
+      }
+    }
+
+    static object_pool& instance() {
+      static object_pool pool;
+      return pool;
+    }
+
+    void grow() {
+      slot* slab = new slot[slabSize];
+      for (size_t idx = 0; idx < slabSize; ++idx) {
+        slab[idx].next = free;
+        free = &slab[idx];
+      }
+      slabs.push_back(slab);
+      stats_.reserved += slabSize;
+    }
+
+    slot* free;
+    std::vector<slot*> slabs;
+    pool_stats stats_;
+
+  };
+
+  /*
+   allocation policy for clazz<T, pooled<T> >, instances constructed from Lua
+   are taken from a per type pool and returned to it when collected, instances
+   pushed from C++ with gc are deleted as usual
+   */
+  template<typename T, size_t slabSize = 64>
+  struct pooled {
+
+    static const bool pooling = true;
+
+    template<typename U>
+    static U* newInstance(lua_State* L, abstract_constructor* ctor) {
+      return ctor->newInstance<U>(L, &object_pool<T, slabSize>::allocate, &object_pool<T, slabSize>::deallocate);
+    }
+
+    template<typename U>
+    static void delete_(wrapper<U*>* w) {
+      if (w->pooled) {
+        w->ref()->~U();
+        object_pool<T, slabSize>::deallocate(w->raw);
+      }
+      else {
+        delete w->ref();
+      }
+    }
+
+    static const pool_stats& stats() {
+      return object_pool<T, slabSize>::stats();
+    }
+
+  };
+
+}
+
+#endif
@@ -21,6 +21,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "call.h"
 #include "converter.h"
 #include <functional>
+#include <vector>
 
 #include <stdexcept>
 
@@ -29,54 +30,117 @@ namespace slub {
   template<typename T>
   struct converter;
 
+  struct reference_path;
+
+  // registry slot shared by all copies of a reference, released with the last
+  // one; references live in any thread that owns a state, so slots are plain
+  // heap objects rather than taken from a process wide pool
+  struct reference_slot {
+    int index;
+    int count;
+    reference_path* path;  // set for table entries, which are looked up on each push
+  };
+
+  /*
+   a table entry named by a chain of keys from an anchored table or the
+   globals; neither the intermediate tables nor the value are anchored in the
+   registry, the chain is walked on the stack whenever the value is needed
+   */
+  struct reference_path {
+
+    struct key {
+      int type;  // LUA_TSTRING or LUA_TNUMBER, other keys are held by a slot
+      string str;
+      lua_Number number;
+      reference_slot* slot;
+    };
+
+    reference_slot* root;  // NULL for the globals table
+    std::vector<key> keys;
+
+    // a path of one more key, the key is popped from the stack; from is the
+    // slot of the table being indexed
+    static reference_path* extend(lua_State* L, reference_slot* from);
+
+    // a path of one more key held by a slot, e.g. an interned key
+    static reference_path* extend(lua_State* L, reference_slot* from, reference_slot* keySlot);
+
+    // pushes the value, nil if any table on the way is nil
+    void push(lua_State* L) const;
+
+    // pushes the table holding the last key and that key, false if the
+    // table is nil, in which case nothing is left on the stack
+    bool pushLast(lua_State* L) const;
+
+    void release(lua_State* L);
+
+  private:
+
+    static reference_path* copy(reference_slot* from);
+
+    // pushes the table holding the key with the given position
+    bool pushTable(lua_State* L, size_t count) const;
+    void pushKey(lua_State* L, const key& k) const;
+
+  };
+
   struct reference {
 
     template<typename T>
     friend struct converter;
+    friend struct reference_path;
 
-    reference() : state(NULL), index(LUA_REFNIL) {
+    reference() : state(NULL), slot(NULL) {
     }
     
-    reference(lua_State* state) : state(state), index(luaL_ref(state, LUA_REGISTRYINDEX)) {
+    reference(lua_State* state) : state(state), slot(acquire(luaL_ref(state, LUA_REGISTRYINDEX))) {
     }
     
     reference(lua_State* state, int index) : state(state) {
       lua_pushvalue(state, index);
-      this->index = luaL_ref(state, LUA_REGISTRYINDEX);
+      slot = acquire(luaL_ref(state, LUA_REGISTRYINDEX));
     }
     
-    reference(const reference& r) {
-      this->operator=(r);
+    // a table entry copied into a reference is a snapshot, see table_entry
+    reference(const reference& r) : state(r.state), slot(r.slot) {
+      if (slot != NULL) {
+        if (slot->path != NULL) {
+          r.push();
+          slot = acquire(luaL_ref(state, LUA_REGISTRYINDEX));
+        }
+        else {
+          ++slot->count;
+        }
+      }
     }
     
     ~reference() {
-      if (index != LUA_REFNIL && state != NULL && lua_status(state) == 0) {
-        luaL_unref(state, LUA_REGISTRYINDEX, index);
-      }
+      release();
       state = NULL;
-      index = LUA_REFNIL;
     }
 
-    virtual bool operator==(const reference& r) {
+    bool operator==(const reference& r) {
       bool result = (lua_equal(state, push(), r.push()) != 0);
       lua_pop(state, 2);
       return result;
     }
 
-    virtual void operator=(const reference& r) {
-      this->state = r.state;
-      if (r.index != LUA_REFNIL) {
+    void operator=(const reference& r) {
+      if (r.slot != NULL && r.slot->path != NULL) {
         r.push();
-        this->index = luaL_ref(state, LUA_REGISTRYINDEX);
+        reference_slot* s = acquire(luaL_ref(r.state, LUA_REGISTRYINDEX));
+        release();
+        this->state = r.state;
+        this->slot = s;
       }
       else {
-        this->index = LUA_REFNIL;
+        share(r);
       }
     }
     
     int type() const {
       int result = LUA_TNIL;
-      if (state != NULL && index != LUA_REFNIL) {
+      if (state != NULL && slot != NULL) {
         result = lua_type(state, push());
         pop();
       }
@@ -90,7 +154,7 @@ namespace slub {
     
     template<typename T>
     T cast() const {
-      if (state == NULL || index == LUA_REFNIL) {
+      if (state == NULL || slot == NULL) {
         throw std::runtime_error("trying to cast a nil value");
       }
       T result = converter<T>::get(state, push());
@@ -99,7 +163,7 @@ namespace slub {
     }
 
     bool isNil() {
-      return state == NULL || index == LUA_REFNIL || type() == LUA_TNIL ||
+      return state == NULL || slot == NULL || type() == LUA_TNIL ||
         type() == LUA_TNONE;
     }
 
@@ -119,24 +183,27 @@ namespace slub {
 
 
     lua_State* state;
-    int index;
+    reference_slot* slot;  // NULL for nil
 
     int push() const {
       return push(state);
     }
 
     int push(lua_State* externalState) const {
-      if (externalState == NULL && index == LUA_REFNIL) {
+      if (externalState == NULL && slot == NULL) {
         throw std::runtime_error("trying to push a nil value");
       }
       else if (state && (externalState != state)) {
         throw std::runtime_error("trying to push to a different state");
       }
-      if (index != LUA_REFNIL) {
-        lua_rawgeti(externalState, LUA_REGISTRYINDEX, index);
+      if (slot == NULL) {
+        lua_pushnil(externalState);
+      }
+      else if (slot->path != NULL) {
+        slot->path->push(externalState);
       }
       else {
-        lua_pushnil(externalState);
+        lua_rawgeti(externalState, LUA_REGISTRYINDEX, slot->index);
       }
       return lua_gettop(externalState);
     }
@@ -146,12 +213,66 @@ namespace slub {
     }
 
     void pop(lua_State* state) const {
-      if (state == NULL && index == LUA_REFNIL) {
+      if (state == NULL && slot == NULL) {
         throw std::runtime_error("trying to pop a nil value");
       }
       lua_pop(state, 1);
     }
 
+  protected:
+
+    static reference_slot* acquire(int index) {
+      if (index == LUA_REFNIL) {
+        return NULL;
+      }
+      reference_slot* s = new reference_slot();
+      s->index = index;
+      s->count = 1;
+      s->path = NULL;
+      return s;
+    }
+
+    static reference_slot* acquire(reference_path* path) {
+      reference_slot* s = new reference_slot();
+      s->index = LUA_NOREF;
+      s->count = 1;
+      s->path = path;
+      return s;
+    }
+
+    static void release(lua_State* state, reference_slot* slot) {
+      if (slot != NULL && --slot->count == 0) {
+        if (slot->path != NULL) {
+          slot->path->release(state);
+          delete slot->path;
+        }
+        else if (state != NULL && lua_status(state) == 0) {
+          luaL_unref(state, LUA_REGISTRYINDEX, slot->index);
+        }
+        delete slot;
+      }
+    }
+
+    // refers to the same slot as r, table entries stay lazy
+    void share(const reference& r) {
+      // r may be this reference, take its slot before releasing ours
+      lua_State* s = r.state;
+      reference_slot* shared = r.slot;
+      if (shared != NULL) {
+        ++shared->count;
+      }
+      release();
+      this->state = s;
+      this->slot = shared;
+    }
+
+  private:
+
+    void release() {
+      release(state, slot);
+      slot = NULL;
+    }
+
   };
 
   template<>
@@ -179,6 +300,33 @@ namespace slub {
   template<>
   struct converter<const reference&> : converter<reference> {};
 
+  /*
+   a string interned once in a state and anchored in the registry, pushing it
+   is a lua_rawgeti instead of hashing the string again; meant for names used
+   over and over, e.g. the fields written to many tables. entries named by a
+   plain string still push, and so hash, that string on every access
+   */
+  struct key : public reference {
+
+    key() : reference() {
+    }
+
+    key(lua_State* state, const string& name) : reference() {
+      lua_pushlstring(state, name.data(), name.size());
+      share(reference(state));
+    }
+
+  };
+
+  template<>
+  struct converter<key> : converter<reference> {};
+
+  template<>
+  struct converter<key&> : converter<reference> {};
+
+  template<>
+  struct converter<const key&> : converter<reference> {};
+
   // table iteration, check for correct table type before passing reference!
   // from func, return false to abort iteration, or return true to continue
   void for_each(slub::reference table, std::function<bool(const slub::reference&, const slub::reference&)> func);
@@ -18,11 +18,14 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #define SLUB_REGISTRY_H
 
 #include "config.h"
+#include "dispatch.h"
 #include "forward.h"
 #include "slub_lua.h"
 
+#include <algorithm>
 #include <iostream>
 #include <typeinfo>
+#include <vector>
 
 namespace slub {
 
@@ -30,17 +33,46 @@ namespace slub {
   struct type_holder {
     static const std::type_info* type;
     static string typeName;
+    static int id;
   };
 
   template<typename T>
   const std::type_info* type_holder<T>::type = NULL;
 
+  template<typename T>
+  int type_holder<T>::id = -1;
+
   template<typename T>
   string type_holder<T>::typeName;
 
   struct registry;
 
-  struct registry_holder : public map<const std::type_info*, registry*> {
+  // a name resolved against a type and all of its bases; field takes
+  // precedence, methods and operators are ordered own first, then bases
+  struct member {
+    member() : field(NULL), direct(NULL) {}
+
+    abstract_field* field;
+    overloads<abstract_method> methods;
+    overloads<abstract_operator> operators;
+    // bound through clazz::method<M, m>, called without overload dispatch
+    lua_CFunction direct;
+  };
+
+  // the overloads of one operator of a type including its bases, kept at a
+  // stable address for the metamethod closures and refreshed on change
+  struct operator_set {
+    operator_set(registry* reg, const string& name) : reg(reg), name(name), revision(0) {}
+
+    const overloads<abstract_operator>& resolve();
+
+    registry* reg;
+    string name;
+    unsigned int revision;
+    overloads<abstract_operator> ops;
+  };
+
+  struct registry_holder : public hash_map<const std::type_info*, registry*> {
     ~registry_holder();
   };
   
@@ -54,7 +86,15 @@ namespace slub {
     static registry* registerType(const string& typeName) {
       type_holder<T>::type = &typeid(T);
       type_holder<T>::typeName = typeName;
-      return get<T>();
+      registry* reg = get<T>();
+      type_holder<T>::id = reg->id;
+      return reg;
+    }
+
+    // dense id of a registered type, -1 if T is not registered
+    template<typename T>
+    static int typeId() {
+      return type_holder<T>::id;
     }
 
     template<typename T>
@@ -66,14 +106,63 @@ namespace slub {
       return instance.find(&type) != instance.end() ? instance[&type] : NULL;
     }
 
+    // registry of the type with the given dense id, NULL if there is none
+    static registry* byId(int id) {
+      return id >= 0 && (size_t) id < ids.size() ? ids[id] : NULL;
+    }
+
     const std::type_info& getType() {
       return type;
     }
+
+    int getId() const {
+      return id;
+    }
     
-    string getTypeName() {
+    const string& getTypeName() const {
       return typeName;
     }
 
+    // pushes the metatable of this type, the first state binding the class
+    // is served by a registry ref, further states by a map of refs; both are
+    // dropped when the state is closed, see watchState
+    void pushMetatable(lua_State* L) {
+      if (lua_topointer(L, LUA_REGISTRYINDEX) == metatableState) {
+        lua_rawgeti(L, LUA_REGISTRYINDEX, metatableRef);
+      }
+      else {
+        pushMetatableSlow(L);
+      }
+    }
+
+    void setMetatable(lua_State* L, int index);
+
+    // remembers the userdata pushed for an instance in a weak table of the
+    // metatable, so pushing the same pointer again yields the same userdata
+    void enableInstanceCache(lua_State* L);
+
+    // instances created by Lua or returned by value are constructed inside
+    // their userdata in this state; another state may bind the type without
+    void enableValueStorage(lua_State* L);
+
+    bool valueStorage(lua_State* L) const {
+      return !valueStorageStates.empty() &&
+        std::find(valueStorageStates.begin(), valueStorageStates.end(), lua_topointer(L, LUA_REGISTRYINDEX)) != valueStorageStates.end();
+    }
+
+    // pushes the live userdata of instance, false if there is none; const
+    // userdata are kept apart from mutable ones
+    bool pushCachedInstance(lua_State* L, void* instance, bool constant = false) {
+      return instanceCache && findCachedInstance(L, instance, constant);
+    }
+
+    // remembers the userdata on top of the stack as the one of instance
+    void cacheInstance(lua_State* L, void* instance, bool constant = false) {
+      if (instanceCache) {
+        storeCachedInstance(L, instance, constant);
+      }
+    }
+
     void addConstructor(abstract_constructor* ctor);
     bool containsConstructor();
     abstract_constructor* getConstructor(lua_State* L);
@@ -83,19 +172,33 @@ namespace slub {
     abstract_field* getField(void* v, const string& fieldName, bool throw_ = true);
     
     void addMethod(const string& methodName, abstract_method* method);
+    void addDirectMethod(const string& methodName, lua_CFunction method);
     bool containsMethod(const string& methodName);
     abstract_method* getMethod(const string& methodName, lua_State* L, bool throw_ = true);
     
     void addOperator(const string& operatorName, abstract_operator* op);
     bool containsOperator(const string& operatorName);
     abstract_operator* getOperator(const string& operatorName, lua_State* L, bool throw_ = true);
+    operator_set* getOperatorSet(const string& operatorName);
     
     void registerBase(registry* base);
     bool hasBase();
-    const list<registry*> baseList();
+    const small_list<registry*>& baseList();
 
-    int getInstanceTable(lua_State* L, void* instance);
-    void removeInstanceTable(lua_State* L, void* instance);
+    // true if this type is the type with the given id or derives from it
+    bool isA(int ancestorId) {
+      const std::vector<unsigned int>& set = ancestors();
+      size_t word = (size_t) ancestorId / 32;
+      return ancestorId >= 0 && word < set.size() && (set[word] & (1u << (ancestorId % 32))) != 0;
+    }
+
+    const hash_map<string, member>& members();
+    const member* findMember(const string& name);
+
+    // bumped whenever any registry changes, used to invalidate caches
+    static unsigned int revision() {
+      return revision_;
+    }
 
   private:
 
@@ -108,7 +211,7 @@ namespace slub {
     static registry* get() {
       registry* reg = NULL;
       const std::type_info& type = typeid(T);
-      map<const std::type_info*, registry*>::iterator iter = instance.find(&type);
+      hash_map<const std::type_info*, registry*>::iterator iter = instance.find(&type);
       if (iter == instance.end()) {
         reg = new registry(type, getTypeName<T>());
         instance[&type] = reg;
@@ -120,23 +223,52 @@ namespace slub {
     }
 
     static registry_holder instance;
+    static std::vector<registry*> ids;
+    static unsigned int revision_;
+    static int nextId_;
 
     registry(const std::type_info& type, const string& typeName);
     ~registry();
     
     const std::type_info& type;
     string typeName;
+    int id;
+
+    void pushMetatableSlow(lua_State* L);
+
+    // states are told apart by the address of their registry table, which a
+    // later state may reuse. A userdata kept in the registry of a state
+    // forgets its refs from its __gc when the state is closed.
+    static void watchState(lua_State* L);
+    static int forgetState(lua_State* L);
+
+    bool findCachedInstance(lua_State* L, void* instance, bool constant);
+    void storeCachedInstance(lua_State* L, void* instance, bool constant);
+
+    const void* metatableState;
+    int metatableRef;
+    hash_map<const void*, int> metatableRefs;
+    small_list<const void*> valueStorageStates;
+    bool instanceCache;
     
-    list<abstract_constructor*> constructors;
+    overloads<abstract_constructor> constructors;
+
+    hash_map<string, abstract_field*> fieldMap;
+    hash_map<string, small_list<abstract_method*> > methodMap;
+    hash_map<string, lua_CFunction> directMap;
+    hash_map<string, small_list<abstract_operator*> > operatorMap;
+    hash_map<string, operator_set*> operatorSets;
+
+    small_list<registry*> baseList_;
 
-    map<string, abstract_field*> fieldMap;
-    map<string, list<abstract_method*> > methodMap;
-    map<string, list<abstract_operator*> > operatorMap;
+    hash_map<string, member> memberMap;
+    unsigned int memberRevision;
 
-    map<long int, int> pushedInstances;
-    map<long int, int> pushedInstancesRefCount;
+    // bitset of the ids of this type and all of its bases
+    const std::vector<unsigned int>& ancestors();
 
-    list<registry*> baseList_;
+    std::vector<unsigned int> ancestorSet;
+    unsigned int ancestorRevision;
 
   };
 
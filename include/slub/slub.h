@@ -27,6 +27,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //#include "globals.h"
 //#include "method.h"
 #include "package.h"
+#include "state.h"
 //#include "reference.h"
 //#include "registry.h"
 //#include "wrapper.h"
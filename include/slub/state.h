@@ -0,0 +1,97 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#ifndef SLUB_STATE_H
+#define SLUB_STATE_H
+
+#include "slub_lua.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace slub {
+
+  struct memory_stats {
+    memory_stats() : bytes(0), peak(0), allocations(0), failures(0) {}
+
+    size_t bytes;  // bytes in use by the state
+    size_t peak;  // highest number of bytes in use so far
+    size_t allocations;  // blocks allocated since the state was created
+    size_t failures;  // allocations refused because of the limit
+  };
+
+  /*
+   lua_Alloc of a state created by newState, blocks of up to 256 bytes are
+   served from free lists in size classes of 16 bytes carved from larger
+   chunks, bigger blocks go to realloc; all bookkeeping is per state
+   */
+  struct allocator {
+
+    allocator(size_t limit);
+    ~allocator();
+
+    static void* alloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+    const memory_stats& stats() const {
+      return stats_;
+    }
+
+    // 0 means unlimited, growing past the limit raises a Lua memory error
+    size_t getLimit() const {
+      return limit;
+    }
+
+    void setLimit(size_t newLimit) {
+      limit = newLimit;
+    }
+
+  private:
+
+    enum { granularity = 16, classes = 16, chunkSize = 16 * 1024 };
+
+    struct block {
+      block* next;
+    };
+
+    // size class of a block, -1 if it is too big to be pooled
+    static int sizeClass(size_t size) {
+      return size <= granularity * classes ? (int) ((size + granularity - 1) / granularity) - 1 : -1;
+    }
+
+    void* allocate(size_t size);
+    void release(void* ptr, size_t size);
+
+    size_t limit;
+    memory_stats stats_;
+    block* free[classes];
+    std::vector<char*> chunks;
+    char* chunkPos;
+    size_t chunkLeft;
+
+  };
+
+  // a new state using its own allocator, limit is in bytes and 0 for none
+  lua_State* newState(size_t limit = 0);
+
+  // the allocator of a state created by newState, NULL for other states
+  allocator* getAllocator(lua_State* L);
+
+  // closes a state created by newState and releases its memory
+  void closeState(lua_State* L);
+
+}
+
+#endif
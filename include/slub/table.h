@@ -26,15 +26,20 @@ namespace slub {
 
   struct globals;
 
+  /*
+   an entry of a table or of the globals, named by the keys leading to it.
+   an entry is lazy: it is looked up whenever it is read, cast or called and
+   assigning a value to it writes that key, any table on the way being nil
+   reads as nil and refuses writes. copying or moving an entry (or a table)
+   keeps it lazy; converting it to a plain reference, by construction or
+   assignment, takes a snapshot of the value it has at that moment
+   */
   struct table_entry : public reference {
     
   protected:
     
     friend struct globals;
 
-    reference key;
-    reference parent;
-    
     table_entry() : reference() {
     }
     
@@ -46,6 +51,12 @@ namespace slub {
     
     table_entry(const reference& r) : reference(r) {
     }
+
+    // an entry looked up through path, which it takes over
+    table_entry(lua_State* state, reference_path* path) : reference() {
+      this->state = state;
+      slot = acquire(path);
+    }
     
   public:
 
@@ -53,41 +64,56 @@ namespace slub {
      * C++98 requires an accessible copy constructor when binding a reference to
      * a temporary; was protected
      */
-    table_entry(const table_entry& r) {
-      reference::operator=(r);
-      key = r.key;
-      parent = r.parent;
+    table_entry(const table_entry& r) : reference() {
+      share(r);
+    }
+
+    // takes over the path of r, which is left nil
+    table_entry(table_entry&& r) : reference() {
+      state = r.state;
+      slot = r.slot;
+      r.slot = NULL;
     }
     
     void operator=(const table_entry& r) {
-      converter<reference>::push(state, parent);
-      int table_index = lua_gettop(state);
-      converter<reference>::push(state, key);
-      converter<reference>::push(state, r);
-      lua_settable(state, table_index);
-      lua_pop(state, 1);
+      assign(r);
     }
 
     template<typename valueType>
     void operator=(valueType value) {
-      converter<reference>::push(state, parent);
-      int table_index = lua_gettop(state);
-      converter<reference>::push(state, key);
-      converter<valueType>::push(state, value);
-      lua_settable(state, table_index);
-      lua_pop(state, 1);
+      assign(value);
     }
     
+    // records the key, nothing is looked up until the entry is used
     template<typename indexType>
     table_entry operator[](indexType index) const {
-      int table_index = push();
+      if (slot == NULL) {
+        throw std::runtime_error("trying to index a nil value");
+      }
       converter<indexType>::push(state, index);
-      lua_pushvalue(state, lua_gettop(state));
-      lua_gettable(state, table_index);
-      table_entry result(state);
-      result.key = reference(state);
-      result.parent = reference(state);
-      return result;
+      return table_entry(state, reference_path::extend(state, slot));
+    }
+
+    table_entry operator[](const key& k) const {
+      if (slot == NULL) {
+        throw std::runtime_error("trying to index a nil value");
+      }
+      return table_entry(state, reference_path::extend(state, slot, k.slot));
+    }
+
+  private:
+
+    template<typename valueType>
+    void assign(const valueType& value) {
+      if (slot == NULL || slot->path == NULL) {
+        throw std::runtime_error("trying to assign to a value that is not a table entry");
+      }
+      if (!slot->path->pushLast(state)) {
+        throw std::runtime_error("trying to index a nil value");
+      }
+      converter<valueType>::push(state, value);
+      lua_settable(state, -3);
+      lua_pop(state, 1);
     }
 
   };
@@ -17,49 +17,139 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #ifndef SLUB_WRAPPER_H
 #define SLUB_WRAPPER_H
 
+#include "registry.h"
 #include "slub_lua.h"
 
+#include <new>
 #include <typeinfo>
+#include <utility>
 
 namespace slub {
 
+  // start of a holder kept in the userdata right behind the wrapper header,
+  // destroyed through a plain function pointer instead of a virtual call
   struct holder_base {
-    virtual ~holder_base() {}
+    void (*destroy)(holder_base* h);
   };
 
+  // smart pointer kept behind the header of a wrapper
+  enum holder_kind {
+    holder_none = 0,
+    holder_boost_shared_ptr,
+    holder_tr1_shared_ptr,
+    holder_std_shared_ptr,
+    holder_boost_intrusive_ptr
+  };
+
+  // header of every userdata of a bound object, kept to two words: the
+  // object, the dense registry id of its dynamic type and packed flags
   struct wrapper_base {
-    const std::type_info* type;
     void* raw;
-  };
+    int id;  // -1 if the type is not registered
+    unsigned int gc : 1;
+    unsigned int inplace : 1;  // the value lives in the userdata behind the wrapper
+    unsigned int instanceTable : 1;  // the userdata environment holds fields set from Lua
+    unsigned int holderKind : 3;  // holder_kind of the holder following the header
+    unsigned int pooled : 1;  // allocated by the pool of its class
+    unsigned int constant : 1;  // pushed as const, does not convert to T* or T&
+
+    registry* reg() const {
+      return registry::byId(id);
+    }
 
-  template<typename T, typename H = holder_base*>
-  struct wrapper : public wrapper_base {
+    // the header of the bound object at index, NULL for any other value,
+    // e.g. userdata of another library, which do not share the metatable of
+    // the class their header would name
+    static wrapper_base* of(lua_State* L, int index) {
+      if (lua_type(L, index) != LUA_TUSERDATA || lua_objlen(L, index) < sizeof(wrapper_base)) {
+        return NULL;
+      }
+      wrapper_base* w = (wrapper_base*) lua_touserdata(L, index);
+      registry* reg = w->reg();
+      if (reg == NULL || !lua_getmetatable(L, index)) {
+        return NULL;
+      }
+      reg->pushMetatable(L);
+      bool bound = lua_rawequal(L, -1, -2) != 0;
+      lua_pop(L, 2);
+      return bound ? w : NULL;
+    }
 
-  private:
-    T _ref;
+    // destroys the holder behind the header
+    void releaseHolder() {
+      holder_base* h = reinterpret_cast<holder_base*>(this + 1);
+      holderKind = holder_none;
+      h->destroy(h);
+    }
+  };
 
-  public:
+  // a smart pointer constructed in place behind the wrapper header
+  template<typename H>
+  struct wrapper_holder : public holder_base {
     H holder;
-    bool gc;
+
+    static void destroyHolder(holder_base* h) {
+      static_cast<wrapper_holder*>(h)->holder.~H();
+    }
+  };
+
+  // takes no room in wrappers without a holder
+  template<>
+  struct wrapper_holder<void> {
+  };
+
+  template<typename T, typename H = void>
+  struct wrapper : public wrapper_base, public wrapper_holder<H> {
 
     static wrapper* create(lua_State* L, const std::type_info& type) {
-      wrapper* w = (wrapper*) lua_newuserdata(L, sizeof(wrapper));
-      w->type = &type;
-      w->holder = NULL;
-      w->_ref = NULL;
-      w->gc = false;
+      return init((wrapper*) lua_newuserdata(L, sizeof(wrapper)), registry::get(type));
+    }
+
+    // reg is the registry of type, saves looking it up again
+    static wrapper* create(lua_State* L, const std::type_info& type, registry* reg) {
+      return init((wrapper*) lua_newuserdata(L, sizeof(wrapper)), reg);
+    }
+
+    // reserves room for a V behind the wrapper, the caller constructs the
+    // value in storage
+    template<typename V>
+    static wrapper* create(lua_State* L, const std::type_info& type, void*& storage) {
+      size_t offset = (sizeof(wrapper) + alignof(V) - 1) / alignof(V) * alignof(V);
+      wrapper* w = init((wrapper*) lua_newuserdata(L, offset + sizeof(V)), registry::get(type));
+      storage = (char*) w + offset;
       return w;
     }
 
     T ref() {
-      return _ref;
+      return static_cast<T>(raw);
     }
 
     void ref(T newRef) {
-      _ref = newRef;
       raw = (void*) newRef;
     }
 
+    // constructs the holder from value, it is destroyed from __gc
+    template<typename P>
+    void hold(P&& value, holder_kind kind) {
+      new (&this->holder) H(std::forward<P>(value));
+      this->destroy = &wrapper_holder<H>::destroyHolder;
+      holderKind = kind;
+    }
+
+  private:
+
+    static wrapper* init(wrapper* w, registry* reg) {
+      w->raw = NULL;
+      w->id = reg != NULL ? reg->getId() : -1;
+      w->gc = false;
+      w->inplace = false;
+      w->instanceTable = false;
+      w->holderKind = holder_none;
+      w->pooled = false;
+      w->constant = false;
+      return w;
+    }
+
   };
 
 }
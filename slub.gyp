@@ -32,13 +32,16 @@
       'direct_dependent_settings': {
 
         'sources': [
+          './include/slub/arguments.h',
           './include/slub/call.h',
           './include/slub/clazz.h',
           './include/slub/config.h',
+          './include/slub/containers.h',
           './include/slub/constructor.h',
           './include/slub/converter.h',
           './include/slub/debug/debugger.h',
           './include/slub/debug/commandline_debugger.h',
+          './include/slub/dispatch.h',
           './include/slub/exception.h',
           './include/slub/field.h',
           './include/slub/forward.h',
@@ -47,10 +50,12 @@
           './include/slub/method.h',
           './include/slub/operators.h',
           './include/slub/package.h',
+          './include/slub/pool.h',
           './include/slub/reference.h',
           './include/slub/registry.h',
           './include/slub/slub.h',
           './include/slub/slub_lua.h',
+          './include/slub/state.h',
           './include/slub/table.h',
           './include/slub/wrapper.h',
 
@@ -59,7 +64,9 @@
           './src/slub/debug/debugger.cpp',
           './src/slub/debug/commandline_debugger.cpp',
           './src/slub/function.cpp',
+          './src/slub/reference.cpp',
           './src/slub/registry.cpp',
+          './src/slub/state.cpp',
         ],
 
       },
@@ -18,10 +18,81 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../include/slub/clazz.h"
 
 #include <iostream>
+#include <new>
 #include <stdexcept>
 
 namespace slub {
 
+  void member_cache::rebuild(lua_State* L, registry* reg, int anchorTable) {
+    const hash_map<string, member>& members = reg->members();
+
+    size_t capacity = 8;
+    while (capacity < members.size() * 2) {
+      capacity <<= 1;
+    }
+    slots.assign(capacity, slot());
+
+    int count = 0;
+    size_t mask = capacity - 1;
+    for (hash_map<string, member>::const_iterator midx = members.begin(); midx != members.end(); ++midx) {
+      // anchor the interned name so its address stays valid as a key,
+      // methods anchor it as upvalue of their dispatch closure
+      lua_pushstring(L, midx->first.c_str());
+      const char* key = lua_tostring(L, -1);
+      int closure = 0;
+      if (midx->second.field == NULL && midx->second.direct != NULL) {
+        // a function a script put into the method table takes precedence
+        reg->pushMetatable(L);
+        lua_getfield(L, -1, "__metatable");
+        lua_pushvalue(L, -3);
+        lua_gettable(L, -2);
+        lua_remove(L, -2);
+        lua_remove(L, -2);
+        if (!lua_isfunction(L, -1)) {
+          lua_pop(L, 1);
+          lua_pushcclosure(L, midx->second.direct, 1);
+        }
+        else {
+          // the name stays anchored as key of the method table
+          lua_remove(L, -2);
+        }
+        closure = count + 1;
+      }
+      else if (midx->second.field == NULL && !midx->second.methods.empty()) {
+        new (lua_newuserdata(L, sizeof(call_cache))) call_cache();
+        lua_pushcclosure(L, abstract_clazz::callMethod, 2);
+        closure = count + 1;
+      }
+      lua_rawseti(L, anchorTable, ++count);
+
+      size_t idx = hash(key) & mask;
+      while (slots[idx].key != NULL) {
+        idx = (idx + 1) & mask;
+      }
+      slots[idx].key = key;
+      slots[idx].value = &midx->second;
+      slots[idx].closure = closure;
+    }
+    for (int idx = count + 1; idx <= anchors; ++idx) {
+      lua_pushnil(L);
+      lua_rawseti(L, anchorTable, idx);
+    }
+    anchors = count;
+
+    indexOperator = reg->findMember("__index");
+    if (indexOperator != NULL && indexOperator->operators.empty()) {
+      indexOperator = NULL;
+    }
+    revision = registry::revision();
+  }
+
+  int member_cache::gc(lua_State* L) {
+    static_cast<member_cache*>(lua_touserdata(L, 1))->~member_cache();
+    return 0;
+  }
+
+  unsigned int abstract_clazz::scriptRevision = 0;
+
   std::pair<int, int> abstract_clazz::construct(lua_State * state, registry * reg, char const * name, char const * fqname, int target)
   {
     lua_newtable(state);
@@ -31,6 +102,7 @@ namespace slub {
       throw new std::runtime_error("already registered: "+ std::string(fqname));
     }
     int metatable = lua_gettop(state);
+    reg->setMetatable(state, metatable);
     
     // store method table in globals so that
     // scripts can add functions written in Lua.
@@ -46,125 +118,141 @@ namespace slub {
 
   void abstract_clazz::add_symbols(lua_State * state, registry * reg, int methods, int metatable)
   {
-    lua_pushliteral(state, "__index");
+    // upvalues shared by __index and __newindex: registry, member cache
+    // and the table anchoring the interned member names
     lua_pushlightuserdata(state, reg);
-    lua_pushcclosure(state, index, 1);
+    new (lua_newuserdata(state, sizeof(member_cache))) member_cache();
+    if (luaL_newmetatable(state, "slub.member_cache")) {
+      lua_pushcfunction(state, member_cache::gc);
+      lua_setfield(state, -2, "__gc");
+    }
+    lua_setmetatable(state, -2);
+    lua_newtable(state);
+    int upvalues = lua_gettop(state) - 2;
+
+    lua_pushliteral(state, "__index");
+    lua_pushvalue(state, upvalues);
+    lua_pushvalue(state, upvalues + 1);
+    lua_pushvalue(state, upvalues + 2);
+    lua_pushcclosure(state, index, 3);
     lua_settable(state, metatable);
     
     lua_pushliteral(state, "__newindex");
-    lua_pushlightuserdata(state, reg);
-    lua_pushcclosure(state, newindex, 1);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__eq");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__eq");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__lt");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__lt");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__le");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__le");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__tostring");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__tostring");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__add");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__add");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__sub");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__sub");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__mul");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__mul");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__div");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__div");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__mod");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__mod");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__pow");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__pow");
-    lua_pushcclosure(state, callOperator, 2);
-    lua_settable(state, metatable);
-    
-    lua_pushliteral(state, "__unm");
-    lua_pushlightuserdata(state, reg);
-    lua_pushstring(state, "__unm");
-    lua_pushcclosure(state, callOperator, 2);
+    lua_pushvalue(state, upvalues);
+    lua_pushvalue(state, upvalues + 1);
+    lua_pushvalue(state, upvalues + 2);
+    lua_pushcclosure(state, newindex, 3);
     lua_settable(state, metatable);
+
+    lua_pop(state, 3);
     
     lua_pop(state, 2);  // drop metatable and method table
   }
 
-  // TODO: access by type
+  void abstract_clazz::addOperatorMetamethod(lua_State* L, registry* reg, const string& name) {
+    // __index operators are served by the member lookup of __index
+    if (name == "__index") {
+      return;
+    }
+    // reg and the classes already derived from it, isA holds for reg itself
+    for (int id = 0; registry* other = registry::byId(id); ++id) {
+      if (other->isA(reg->getId())) {
+        installOperatorMetamethod(L, other, name);
+      }
+    }
+  }
+
+  void abstract_clazz::installOperatorMetamethod(lua_State* L, registry* reg, const string& name) {
+    // skips types not bound to this state
+    reg->pushMetatable(L);
+    if (!lua_istable(L, -1)) {
+      lua_pop(L, 1);
+      return;
+    }
+    lua_pushlstring(L, name.data(), name.size());
+    lua_rawget(L, -2);
+    if (lua_isnil(L, -1)) {
+      lua_pop(L, 1);
+      lua_pushlstring(L, name.data(), name.size());
+      lua_pushlightuserdata(L, reg->getOperatorSet(name));
+      lua_pushcclosure(L, callOperator, 1);
+      lua_rawset(L, -3);
+    }
+    else {
+      lua_pop(L, 1);
+    }
+    lua_pop(L, 1);
+  }
+
+  void abstract_clazz::addOperatorMetamethods(lua_State* L, registry* reg, registry* base) {
+    const hash_map<string, member>& members = base->members();
+    for (hash_map<string, member>::const_iterator idx = members.begin(); idx != members.end(); ++idx) {
+      if (!idx->second.operators.empty()) {
+        addOperatorMetamethod(L, reg, idx->first);
+      }
+    }
+  }
+
+  const member_cache::slot* abstract_clazz::findMember(lua_State* L, registry* reg, int index) {
+    // refreshed for any key, the __index operator is read from the cache too
+    member_cache* cache = static_cast<member_cache*>(lua_touserdata(L, lua_upvalueindex(2)));
+    if (cache->revision != registry::revision() || cache->scriptRevision != scriptRevision) {
+      cache->rebuild(L, reg, lua_upvalueindex(3));
+      cache->scriptRevision = scriptRevision;
+    }
+    if (lua_type(L, index) != LUA_TSTRING) {
+      return NULL;
+    }
+    return cache->find(lua_tostring(L, index));
+  }
+
   int abstract_clazz::index(lua_State* L) {
-    registry* reg = registry::get(*((wrapper_base*) lua_touserdata(L, 1))->type);
+    registry* reg = static_cast<registry*>(lua_touserdata(L, lua_upvalueindex(1)));
     if (reg != NULL) {
-      const char* name = lua_tostring(L, -1);
-
-      reg->getInstanceTable(L, ((wrapper_base*) lua_touserdata(L, 1))->raw);
-      lua_pushstring(L, name);
-      lua_rawget(L, -2);
-      if (lua_type(L, lua_gettop(L)) != LUA_TNIL) {
-        lua_remove(L, -2);
+      bool found = false;
+      if (((wrapper_base*) lua_touserdata(L, 1))->instanceTable) {
+        lua_getfenv(L, 1);
+        lua_pushvalue(L, 2);
+        lua_rawget(L, -2);
+        found = lua_type(L, -1) != LUA_TNIL;
+        if (found) {
+          lua_remove(L, -2);
+        }
+        else {
+          lua_pop(L, 2);
+        }
+      }
+      if (found) {
         return 1;
       }
       else {
-        lua_pop(L, 2);
 
-        if (reg->containsField(name)) {
-          return reg->getField(lua_touserdata(L, 1), name)->get(L);
+        const member_cache::slot* m = findMember(L, reg, 2);
+        if (m != NULL && m->value->field != NULL) {
+          return m->value->field->get(L);
         }
-        else if (reg->containsMethod(name)) {
-          lua_pushvalue(L, -1);
-          lua_pushcclosure(L, callMethod, 1);
+        else if (m != NULL && m->closure != 0) {
+          lua_rawgeti(L, lua_upvalueindex(3), m->closure);
           return 1;
         }
-        else if (reg->containsOperator("__index") && reg->getOperator("__index", L, false) != NULL) {
+
+        const member* indexOperator = static_cast<member_cache*>(lua_touserdata(L, lua_upvalueindex(2)))->indexOperator;
+        abstract_operator* op = indexOperator != NULL ? indexOperator->operators.find(L) : NULL;
+        if (op != NULL) {
           int num = lua_gettop(L);
-          reg->getOperator("__index", L)->op(L);
+          op->op(L);
           return lua_gettop(L) - num;
         }
-        else {
-          // get value from Lua table
-          luaL_getmetatable(L, reg->getTypeName().c_str());
-          lua_getfield(L, -1, "__metatable");
-          int methods = lua_gettop(L);
+
+        // get value from Lua table
+        reg->pushMetatable(L);
+        lua_getfield(L, -1, "__metatable");
+        int methods = lua_gettop(L);
         
-          lua_pushvalue(L, -3);
-          lua_gettable(L, methods);
+        lua_pushvalue(L, 2);
+        lua_gettable(L, methods);
           
-          return 1;
-        }
+        return 1;
       }
     }
     return 0;
@@ -172,18 +260,21 @@ namespace slub {
   
   int abstract_clazz::newindex(lua_State* L) {
     wrapper_base* w = (wrapper_base*) lua_touserdata(L, 1);
-    registry* reg = registry::get(*(w)->type);
+    registry* reg = static_cast<registry*>(lua_touserdata(L, lua_upvalueindex(1)));
     if (reg != NULL) {
-      string name(lua_tostring(L, -2));
-      if (reg->containsField(name)) {
-        return reg->getField(lua_touserdata(L, 1), name)->set(L);
+      const member_cache::slot* m = findMember(L, reg, 2);
+      if (m != NULL && m->value->field != NULL) {
+        return m->value->field->set(L);
       }
       else {
-<<<<<<< HEAD
-        reg->getInstanceTable(L, w->raw);
-=======
+        // the instance table lives in the userdata environment, created on
+        // the first assignment of a key that is no field
+        if (!w->instanceTable) {
+          lua_newtable(L);
+          lua_setfenv(L, 1);
+          w->instanceTable = true;
+        }
         lua_getfenv(L, 1);
->>>>>>> 69c06d6aa17841556b8e449842d892309e05529f
         lua_pushvalue(L, -3);
         lua_pushvalue(L, -3);
         lua_rawset(L, -3);
@@ -194,18 +285,41 @@ namespace slub {
     return 0;
   }
   
+  int abstract_clazz::methodTableNewindex(lua_State* L) {
+    ++scriptRevision;
+    lua_rawset(L, 1);
+    return 0;
+  }
+
   int abstract_clazz::callMethod(lua_State* L) {
-    void* ud = lua_touserdata(L, 1);
-    if(!ud) {
+    int self = call_cache::classOf(L, 1);
+    if (self < 0) {
        throw std::runtime_error("callMethod failed, did you use '.' instead of ':'?");
     }
-    registry* reg = registry::get(*((wrapper_base*) ud)->type);
-    const char* methodName = lua_tostring(L, lua_upvalueindex(1));
-
+    registry* reg = registry::byId(self / 2);
     int numParams = lua_gettop(L);
 
+    call_cache* cache = static_cast<call_cache*>(lua_touserdata(L, lua_upvalueindex(2)));
+    if (cache->revision != registry::revision() || cache->scriptRevision != scriptRevision) {
+      cache->clear();
+      cache->revision = registry::revision();
+      cache->scriptRevision = scriptRevision;
+    }
+    unsigned int types = 0;
+    int classes[call_cache::max_args];
+    bool cacheable = call_cache::key(L, numParams, types, classes);
+    if (cacheable) {
+      const call_cache::entry* e = cache->find(self, numParams, types, classes);
+      if (e != NULL && (e->exact || e->method->check(L))) {
+        e->method->call(L);
+        return lua_gettop(L) - numParams;
+      }
+    }
+
+    const char* methodName = lua_tostring(L, lua_upvalueindex(1));
+
     // try to get value from Lua table
-    luaL_getmetatable(L, reg->getTypeName().c_str());
+    reg->pushMetatable(L);
     lua_getfield(L, -1, "__metatable");
     int methods = lua_gettop(L);
       
@@ -215,24 +329,42 @@ namespace slub {
     lua_remove(L, -2);
 
     if (lua_isfunction(L, lua_gettop(L))) {
+      // a function added by a script takes precedence, called with self and
+      // the arguments
+      lua_insert(L, 1);
       slub::call(L, numParams, LUA_MULTRET);
+      return lua_gettop(L);
     }
     else {
       lua_pop(L, 1);
-      reg->getMethod(methodName, L)->call(L);
+      // cache what the key decides; a single match by Lua types is cached
+      // as well but still checked on a hit, e.g. numeric strings
+      bool typed = false;
+      const member* m = reg->findMember(methodName);
+      abstract_method* method = m != NULL ? m->methods.find(L, &typed) : NULL;
+      if (method == NULL) {
+        method = reg->getMethod(methodName, L);
+      }
+      bool exact = m != NULL && m->methods.decides(L, 2);
+      if (cacheable && (typed || exact)) {
+        cache->insert(self, numParams, types, classes, method, exact);
+      }
+      method->call(L);
     }
 
     return lua_gettop(L) - numParams;
   }
   
   int abstract_clazz::callOperator(lua_State* L) {
-    registry* reg = registry::get(*((wrapper_base*) lua_touserdata(L, 1))->type);
-    if (reg != NULL) {
-      int num = lua_gettop(L);
-      reg->getOperator(lua_tostring(L, lua_upvalueindex(2)), L)->op(L);
-      return lua_gettop(L) - num;
+    operator_set* set = static_cast<operator_set*>(lua_touserdata(L, lua_upvalueindex(1)));
+    int num = lua_gettop(L);
+    abstract_operator* op = set->resolve().find(L);
+    if (op == NULL) {
+      // raises the not found error
+      op = set->reg->getOperator(set->name, L);
     }
-    return 0;
+    op->op(L);
+    return lua_gettop(L) - num;
   }
   
 }
@@ -74,7 +74,7 @@ namespace slub {
     bool debugger::toggleSymbolBreakpoint(lua_State* state, string symbol) {
       bool wasActive = false;
       if (symbol_breakpoints.find(state) != symbol_breakpoints.end()) {
-        for (list<string>::iterator iter = symbol_breakpoints[state].begin();
+        for (small_list<string>::iterator iter = symbol_breakpoints[state].begin();
              iter != symbol_breakpoints[state].end(); ++iter)
         {
           if (*iter == symbol) {
@@ -100,7 +100,7 @@ namespace slub {
       if (line_breakpoints.find(state) != line_breakpoints.end() &&
           line_breakpoints[state].find(module) != line_breakpoints[state].end())
       {
-        for (list<int>::iterator iter = line_breakpoints[state][module].begin();
+        for (small_list<int>::iterator iter = line_breakpoints[state][module].begin();
              iter != line_breakpoints[state][module].end(); ++iter)
         {
           if (*iter == line) {
@@ -212,7 +212,7 @@ namespace slub {
             if (symbol_breakpoints.find(state) != symbol_breakpoints.end() &&
                 ar->name != NULL)
             {
-              for (list<string>::iterator iter = symbol_breakpoints[state].begin();
+              for (small_list<string>::iterator iter = symbol_breakpoints[state].begin();
                    iter != symbol_breakpoints[state].end(); ++iter)
               {
                 if (*iter == ar->name) {
@@ -235,7 +235,7 @@ namespace slub {
                 ar->short_src != NULL &&
                 line_breakpoints[state].find(ar->short_src) != line_breakpoints[state].end())
             {
-              for (list<int>::iterator iter = line_breakpoints[state][ar->short_src].begin();
+              for (small_list<int>::iterator iter = line_breakpoints[state][ar->short_src].begin();
                    iter != line_breakpoints[state][ar->short_src].end(); ++iter)
               {
                 if (*iter == ar->currentline) {
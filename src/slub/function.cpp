@@ -28,10 +28,11 @@ namespace slub {
   function_holder::~function_holder() {
 //    std::cout << "cleanup functions" << std::endl;
     
-    for (map<string, list<abstract_function_wrapper*> >::iterator idx = functions.begin(); idx != functions.end(); ++idx) {
-      for (list<abstract_function_wrapper*>::iterator fidx = idx->second.begin(); fidx != idx->second.end(); ++fidx) {
+    for (hash_map<string, function_set*>::iterator idx = functions.begin(); idx != functions.end(); ++idx) {
+      for (small_list<abstract_function_wrapper*>::iterator fidx = idx->second->functions.candidates.begin(); fidx != idx->second->functions.candidates.end(); ++fidx) {
         delete *fidx;
       }
+      delete idx->second;
     }
     functions.clear();
   }
@@ -39,24 +40,33 @@ namespace slub {
   void function_holder::add(lua_State* L, const string& name, abstract_function_wrapper* f, const string& prefix, int target) {
     string qualifiedName = prefix.size() > 0 ? prefix +"."+ name : name;
 
-    instance.functions[qualifiedName].push_back(f);
+    function_set*& set = instance.functions[qualifiedName];
+    if (set == NULL) {
+      set = new function_set(qualifiedName);
+    }
+    set->single = set->functions.empty() ? f : NULL;
+    set->functions.add(f);
 
-    lua_pushstring(L, qualifiedName.c_str());
+    lua_pushlightuserdata(L, set);
     lua_pushcclosure(L, call, 1);
     lua_setfield(L, target != -1 ? target : LUA_GLOBALSINDEX, name.c_str());
   }
 
   int function_holder::call(lua_State* L) {
-    string name(lua_tolstring(L, lua_upvalueindex(1), NULL));
-    for (list<abstract_function_wrapper*>::iterator idx = instance.functions[name].begin(); idx != instance.functions[name].end(); ++idx) {
-      abstract_function_wrapper* f = *idx;
-      if (f->check(L)) {
-        int num = lua_gettop(L);
-        f->call(L);
-        return lua_gettop(L) - num;
-      }
+    function_set* set = static_cast<function_set*>(lua_touserdata(L, lua_upvalueindex(1)));
+    abstract_function_wrapper* f;
+    if (set->single != NULL) {
+      f = set->single->check(L) ? set->single : NULL;
+    }
+    else {
+      f = set->functions.find(L);
+    }
+    if (f != NULL) {
+      int num = lua_gettop(L);
+      f->call(L);
+      return lua_gettop(L) - num;
     }
-    OverloadNotFoundException e(name);
+    OverloadNotFoundException e(set->name);
     lua_pushstring(L, e.what());
     lua_error(L);
     throw e;
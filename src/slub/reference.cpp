@@ -0,0 +1,144 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "../../include/slub/config.h"
+#include "../../include/slub/reference.h"
+
+namespace slub {
+
+  reference_path* reference_path::copy(reference_slot* from) {
+    reference_path* path = new reference_path();
+    if (from != NULL && from->path != NULL) {
+      // the chain continues from the anchored table of from
+      path->root = from->path->root;
+      path->keys = from->path->keys;
+      for (size_t idx = 0; idx < path->keys.size(); ++idx) {
+        if (path->keys[idx].slot != NULL) {
+          ++path->keys[idx].slot->count;
+        }
+      }
+    }
+    else {
+      path->root = from;
+    }
+    if (path->root != NULL) {
+      ++path->root->count;
+    }
+    return path;
+  }
+
+  reference_path* reference_path::extend(lua_State* L, reference_slot* from) {
+    reference_path* path = copy(from);
+    key k;
+    k.type = lua_type(L, -1);
+    k.number = 0;
+    k.slot = NULL;
+    if (k.type == LUA_TSTRING) {
+      size_t length;
+      const char* str = lua_tolstring(L, -1, &length);
+      k.str.assign(str, length);
+      lua_pop(L, 1);
+    }
+    else if (k.type == LUA_TNUMBER) {
+      k.number = lua_tonumber(L, -1);
+      lua_pop(L, 1);
+    }
+    else {
+      k.type = LUA_TNONE;
+      k.slot = reference::acquire(luaL_ref(L, LUA_REGISTRYINDEX));
+    }
+    path->keys.push_back(k);
+    return path;
+  }
+
+  reference_path* reference_path::extend(lua_State* L, reference_slot* from, reference_slot* keySlot) {
+    reference_path* path = copy(from);
+    key k;
+    k.type = LUA_TNONE;
+    k.number = 0;
+    k.slot = keySlot;
+    if (keySlot != NULL) {
+      ++keySlot->count;
+    }
+    path->keys.push_back(k);
+    return path;
+  }
+
+  void reference_path::push(lua_State* L) const {
+    if (pushLast(L)) {
+      lua_gettable(L, -2);
+      lua_remove(L, -2);
+    }
+    else {
+      lua_pushnil(L);
+    }
+  }
+
+  bool reference_path::pushLast(lua_State* L) const {
+    if (!pushTable(L, keys.size() - 1)) {
+      return false;
+    }
+    pushKey(L, keys.back());
+    return true;
+  }
+
+  void reference_path::release(lua_State* L) {
+    for (size_t idx = 0; idx < keys.size(); ++idx) {
+      reference::release(L, keys[idx].slot);
+    }
+    keys.clear();
+    reference::release(L, root);
+    root = NULL;
+  }
+
+  bool reference_path::pushTable(lua_State* L, size_t count) const {
+    if (root != NULL) {
+      lua_rawgeti(L, LUA_REGISTRYINDEX, root->index);
+    }
+    else {
+      lua_pushvalue(L, LUA_GLOBALSINDEX);
+    }
+    for (size_t idx = 0; idx < count; ++idx) {
+      if (lua_isnil(L, -1)) {
+        break;
+      }
+      pushKey(L, keys[idx]);
+      lua_gettable(L, -2);
+      lua_remove(L, -2);
+    }
+    if (lua_isnil(L, -1)) {
+      lua_pop(L, 1);
+      return false;
+    }
+    return true;
+  }
+
+  void reference_path::pushKey(lua_State* L, const key& k) const {
+    if (k.type == LUA_TSTRING) {
+      lua_pushlstring(L, k.str.data(), k.str.size());
+    }
+    else if (k.type == LUA_TNUMBER) {
+      lua_pushnumber(L, k.number);
+    }
+    else if (k.slot != NULL) {
+      lua_rawgeti(L, LUA_REGISTRYINDEX, k.slot->index);
+    }
+    else {
+      lua_pushnil(L);
+    }
+  }
+
+}
@@ -22,57 +22,175 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../../include/slub/method.h"
 #include "../../include/slub/operators.h"
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
 namespace slub {
 
   registry_holder registry::instance;
+  std::vector<registry*> registry::ids;
+  unsigned int registry::revision_ = 1;
+  int registry::nextId_ = 0;
 
   registry_holder::~registry_holder() {
-    for (map<const std::type_info*, registry*>::iterator idx = begin(); idx != end(); ++idx) {
+    for (hash_map<const std::type_info*, registry*>::iterator idx = begin(); idx != end(); ++idx) {
       delete idx->second;
     }
     clear();
   }
 
   registry::registry(const std::type_info& type, const string& typeName)
-  : type(type), typeName(typeName)
+  : type(type), typeName(typeName), id(nextId_++), metatableState(NULL), metatableRef(LUA_NOREF),
+    instanceCache(false), memberRevision(0), ancestorRevision(0)
   {
+    ids.push_back(this);
   }
 
   registry::~registry() {
-    for (list<abstract_constructor*>::iterator midx = constructors.begin(); midx != constructors.end(); ++midx) {
+    for (small_list<abstract_constructor*>::iterator midx = constructors.candidates.begin(); midx != constructors.candidates.end(); ++midx) {
       delete *midx;
     }
-    constructors.clear();
     
-    for (map<string, abstract_field*>::iterator idx = fieldMap.begin(); idx != fieldMap.end(); ++idx) {
+    for (hash_map<string, abstract_field*>::iterator idx = fieldMap.begin(); idx != fieldMap.end(); ++idx) {
       delete idx->second;
     }
     fieldMap.clear();
     
-    for (map<string, list<abstract_method*> >::iterator idx = methodMap.begin(); idx != methodMap.end(); ++idx) {
-      for (list<abstract_method*>::iterator midx = idx->second.begin(); midx != idx->second.end(); ++midx) {
+    for (hash_map<string, small_list<abstract_method*> >::iterator idx = methodMap.begin(); idx != methodMap.end(); ++idx) {
+      for (small_list<abstract_method*>::iterator midx = idx->second.begin(); midx != idx->second.end(); ++midx) {
         delete *midx;
       }
     }
     methodMap.clear();
     
-    for (map<string, list<abstract_operator*> >::iterator idx = operatorMap.begin(); idx != operatorMap.end(); ++idx) {
-      for (list<abstract_operator*>::iterator midx = idx->second.begin(); midx != idx->second.end(); ++midx) {
+    for (hash_map<string, small_list<abstract_operator*> >::iterator idx = operatorMap.begin(); idx != operatorMap.end(); ++idx) {
+      for (small_list<abstract_operator*>::iterator midx = idx->second.begin(); midx != idx->second.end(); ++midx) {
         delete *midx;
       }
     }
     operatorMap.clear();
+
+    for (hash_map<string, operator_set*>::iterator idx = operatorSets.begin(); idx != operatorSets.end(); ++idx) {
+      delete idx->second;
+    }
+    operatorSets.clear();
   }
   
+  void registry::setMetatable(lua_State* L, int index) {
+    const void* state = lua_topointer(L, LUA_REGISTRYINDEX);
+    watchState(L);
+    lua_pushvalue(L, index);
+    int ref = luaL_ref(L, LUA_REGISTRYINDEX);
+    if (metatableState == NULL || metatableState == state) {
+      metatableState = state;
+      metatableRef = ref;
+    }
+    else {
+      metatableRefs[state] = ref;
+    }
+  }
+
+  void registry::pushMetatableSlow(lua_State* L) {
+    hash_map<const void*, int>::iterator idx = metatableRefs.find(lua_topointer(L, LUA_REGISTRYINDEX));
+    if (idx != metatableRefs.end()) {
+      lua_rawgeti(L, LUA_REGISTRYINDEX, idx->second);
+    }
+    else {
+      luaL_getmetatable(L, typeName.c_str());
+    }
+  }
+
+  void registry::watchState(lua_State* L) {
+    lua_getfield(L, LUA_REGISTRYINDEX, "slub.state_watch");
+    if (lua_isnil(L, -1)) {
+      lua_newuserdata(L, 1);
+      lua_newtable(L);
+      lua_pushcfunction(L, forgetState);
+      lua_setfield(L, -2, "__gc");
+      lua_setmetatable(L, -2);
+      lua_setfield(L, LUA_REGISTRYINDEX, "slub.state_watch");
+    }
+    lua_pop(L, 1);
+  }
+
+  int registry::forgetState(lua_State* L) {
+    const void* state = lua_topointer(L, LUA_REGISTRYINDEX);
+    for (std::vector<registry*>::iterator idx = ids.begin(); idx != ids.end(); ++idx) {
+      registry* reg = *idx;
+      if (reg->metatableState == state) {
+        reg->metatableState = NULL;
+        reg->metatableRef = LUA_NOREF;
+      }
+      reg->metatableRefs.erase(state);
+      small_list<const void*>::iterator vidx = std::find(reg->valueStorageStates.begin(), reg->valueStorageStates.end(), state);
+      if (vidx != reg->valueStorageStates.end()) {
+        reg->valueStorageStates.erase(vidx);
+      }
+    }
+    return 0;
+  }
+
+  // the instance caches are kept in the metatable at these array indices,
+  // mutable userdata first, const ones behind
+  static const int instanceCacheIndex = 1;
+
+  void registry::enableInstanceCache(lua_State* L) {
+    pushMetatable(L);
+    for (int idx = 0; idx < 2; ++idx) {
+      lua_newtable(L);
+      lua_newtable(L);
+      lua_pushliteral(L, "v");
+      lua_setfield(L, -2, "__mode");
+      lua_setmetatable(L, -2);
+      lua_rawseti(L, -2, instanceCacheIndex + idx);
+    }
+    lua_pop(L, 1);
+    instanceCache = true;
+  }
+
+  void registry::enableValueStorage(lua_State* L) {
+    if (!valueStorage(L)) {
+      watchState(L);
+      valueStorageStates.push_back(lua_topointer(L, LUA_REGISTRYINDEX));
+    }
+  }
+
+  bool registry::findCachedInstance(lua_State* L, void* instance, bool constant) {
+    pushMetatable(L);
+    lua_rawgeti(L, -1, instanceCacheIndex + (constant ? 1 : 0));
+    if (lua_type(L, -1) == LUA_TTABLE) {
+      lua_pushlightuserdata(L, instance);
+      lua_rawget(L, -2);
+      if (lua_type(L, -1) == LUA_TUSERDATA) {
+        lua_replace(L, -3);
+        lua_pop(L, 1);
+        return true;
+      }
+      lua_pop(L, 1);
+    }
+    lua_pop(L, 2);
+    return false;
+  }
+
+  void registry::storeCachedInstance(lua_State* L, void* instance, bool constant) {
+    int index = lua_gettop(L);
+    pushMetatable(L);
+    lua_rawgeti(L, -1, instanceCacheIndex + (constant ? 1 : 0));
+    if (lua_type(L, -1) == LUA_TTABLE) {
+      lua_pushlightuserdata(L, instance);
+      lua_pushvalue(L, index);
+      lua_rawset(L, -3);
+    }
+    lua_pop(L, 2);
+  }
+
   void registry::addConstructor(abstract_constructor* ctor) {
-    constructors.push_back(ctor);
+    constructors.add(ctor);
   }
   
   bool registry::containsConstructor() {
-    return constructors.size() > 0;
+    return !constructors.empty();
   }
   
   abstract_constructor* registry::getConstructor(lua_State* L) {
@@ -83,10 +201,9 @@ namespace slub {
       throw e;
     }
     
-    for (list<abstract_constructor*>::iterator cidx = constructors.begin(); cidx != constructors.end(); ++cidx) {
-      if ((*cidx)->check(L)) {
-        return *cidx;
-      }
+    abstract_constructor* ctor = constructors.find(L);
+    if (ctor != NULL) {
+      return ctor;
     }
     OverloadNotFoundException e(typeName);
     lua_pushstring(L, e.what());
@@ -96,28 +213,17 @@ namespace slub {
   
   void registry::addField(const string& fieldName, abstract_field* field) {
     fieldMap[fieldName] = field;
+    ++revision_;
   }
   
   bool registry::containsField(const string& fieldName) {
-    bool result = fieldMap.find(fieldName) != fieldMap.end();
-    if (!result && hasBase()) {
-      for (list<registry*>::iterator idx = baseList_.begin(); !result && idx != baseList_.end(); ++idx) {
-        result = (*idx)->containsField(fieldName);
-      }
-    }
-    return result;
+    const member* m = findMember(fieldName);
+    return m != NULL && m->field != NULL;
   }
   
   abstract_field* registry::getField(void* v, const string& fieldName, bool throw_) {
-    abstract_field* result = NULL;
-    if (fieldMap.find(fieldName) != fieldMap.end()) {
-      result = fieldMap[fieldName];
-    }
-    if (result == NULL && hasBase()) {
-      for (list<registry*>::iterator idx = baseList_.begin(); result == NULL && idx != baseList_.end(); ++idx) {
-        result = (*idx)->getField(v, fieldName, false);
-      }
-    }
+    const member* m = findMember(fieldName);
+    abstract_field* result = m != NULL ? m->field : NULL;
 
     if (result == NULL && throw_) {
       throw FieldNotFoundException(typeName +"."+ fieldName);
@@ -127,47 +233,27 @@ namespace slub {
   
   void registry::addMethod(const string& methodName, abstract_method* method) {
     methodMap[methodName].push_back(method);
+    ++revision_;
   }
   
+  void registry::addDirectMethod(const string& methodName, lua_CFunction method) {
+    directMap[methodName] = method;
+    ++revision_;
+  }
+
   bool registry::containsMethod(const string& methodName) {
-    bool result = methodMap.find(methodName) != methodMap.end();
-    if (!result && hasBase()) {
-      for (list<registry*>::iterator idx = baseList_.begin(); !result && idx != baseList_.end(); ++idx) {
-        result = (*idx)->containsMethod(methodName);
-      }
-    }
-    return result;
+    const member* m = findMember(methodName);
+    return m != NULL && !m->methods.empty();
   }
   
   abstract_method* registry::getMethod(const string& methodName, lua_State* L, bool throw_) {
-    struct method_not_found : public abstract_method {
-      method_not_found() {}
-      bool check(lua_State*) {return false;}
-      int call(lua_State*) {return 0;}
-    };
-    static method_not_found not_found;
-
-    abstract_method* result = &not_found;
-    if (methodMap.find(methodName) != methodMap.end()) {
-      result = NULL;
-      for (list<abstract_method*>::iterator midx = methodMap[methodName].begin();
-           (result == &not_found || result == NULL) && midx != methodMap[methodName].end(); ++midx) {
-        if ((*midx)->check(L)) {
-          result = *midx;
-        }
-      }
-    }
-    if ((result == &not_found || result == NULL) && hasBase()) {
-      for (list<registry*>::iterator idx = baseList_.begin();
-           (result == &not_found || result == NULL) && idx != baseList_.end(); ++idx) {
-        abstract_method* r = (*idx)->getMethod(methodName, L, false);
-        if ((r != &not_found && r != NULL) || result == &not_found) {
-          result = r;
-        }
-      }
+    const member* m = findMember(methodName);
+    abstract_method* result = m != NULL ? m->methods.find(L) : NULL;
+    if (result != NULL) {
+      return result;
     }
     
-    if ((result == &not_found || result == NULL) && throw_) {
+    if (throw_) {
       string s;
       int n = lua_gettop(L);
       for (int idx = 1; idx < n; ++idx) {
@@ -183,7 +269,7 @@ namespace slub {
         s += ")";
       }
 
-      if (result == &not_found) {
+      if (m == NULL || m->methods.empty()) {
         MethodNotFoundException e(typeName +"."+ methodName + s);
         lua_pushstring(L, e.what());
         lua_error(L);
@@ -196,55 +282,28 @@ namespace slub {
         throw e;
       }
     }
-    return result;
+    return NULL;
   }
   
   void registry::addOperator(const string& operatorName, abstract_operator* op) {
     operatorMap[operatorName].push_back(op);
+    ++revision_;
   }
   
   bool registry::containsOperator(const string& operatorName) {
-    bool result = operatorMap.find(operatorName) != operatorMap.end();
-    if (!result && hasBase()) {
-      for (list<registry*>::iterator idx = baseList_.begin(); !result && idx != baseList_.end(); ++idx) {
-        result = (*idx)->containsOperator(operatorName);
-      }
-    }
-    return result;
+    const member* m = findMember(operatorName);
+    return m != NULL && !m->operators.empty();
   }
   
   abstract_operator* registry::getOperator(const string& operatorName, lua_State* L, bool throw_) {
-    struct operator_not_found : public abstract_operator {
-      operator_not_found() {}
-      bool check(lua_State*) {return false;}
-      int op(lua_State*) {return 0;}
-    };
-    static operator_not_found not_found;
-
-    abstract_operator* result = &not_found;
-    if (operatorMap.find(operatorName) != operatorMap.end()) {
-      result = NULL;
-      for (list<abstract_operator*>::iterator oidx = operatorMap[operatorName].begin();
-           (result == &not_found || result == NULL) && oidx != operatorMap[operatorName].end(); ++oidx)
-      {
-        if ((*oidx)->check(L)) {
-          result = *oidx;
-        }
-      }
-    }
-    if ((result == &not_found || result == NULL) && hasBase()) {
-      for (list<registry*>::iterator idx = baseList_.begin();
-           (result == &not_found || result == NULL) && idx != baseList_.end(); ++idx)
-      {
-        abstract_operator* r = (*idx)->getOperator(operatorName, L, false);
-        if ((r != &not_found && r != NULL) || result == &not_found) {
-          result = r;
-        }
-      }
+    const member* m = findMember(operatorName);
+    abstract_operator* result = m != NULL ? m->operators.find(L) : NULL;
+    if (result != NULL) {
+      return result;
     }
 
-    if ((result == &not_found || result == NULL) && throw_) {
-      if (result == &not_found) {
+    if (throw_) {
+      if (m == NULL || m->operators.empty()) {
         OperatorNotFoundException e(typeName +"."+ operatorName);
         lua_pushstring(L, e.what());
         lua_error(L);
@@ -257,41 +316,111 @@ namespace slub {
         throw e;
       }
     }
-    return result;
+    return NULL;
+  }
+
+  operator_set* registry::getOperatorSet(const string& operatorName) {
+    hash_map<string, operator_set*>::iterator iter = operatorSets.find(operatorName);
+    if (iter != operatorSets.end()) {
+      return iter->second;
+    }
+    operator_set* set = new operator_set(this, operatorName);
+    operatorSets[operatorName] = set;
+    return set;
+  }
+
+  const overloads<abstract_operator>& operator_set::resolve() {
+    if (revision != registry::revision()) {
+      ops = overloads<abstract_operator>();
+      const member* m = reg->findMember(name);
+      if (m != NULL) {
+        ops.add(m->operators);
+      }
+      revision = registry::revision();
+    }
+    return ops;
   }
 
   void registry::registerBase(registry* base) {
     baseList_.push_back(base);
+    ++revision_;
   }
 
   bool registry::hasBase() {
     return baseList_.size() > 0;
   }
 
-  const list<registry*> registry::baseList() {
+  const small_list<registry*>& registry::baseList() {
     return baseList_;
   }
 
-  int registry::getInstanceTable(lua_State* L, void* instance) {
-    if (pushedInstances.find((long int) instance) == pushedInstances.end()) {
-      lua_newtable(L);
-      pushedInstances[(long int) instance] = luaL_ref(L, LUA_REGISTRYINDEX);
-      pushedInstancesRefCount[(long int) instance] = 1;
-    }
-    else {
-      pushedInstancesRefCount[(long int) instance] += 1;
+  const std::vector<unsigned int>& registry::ancestors() {
+    if (ancestorRevision != revision_) {
+      ancestorSet.assign(id / 32 + 1, 0);
+      ancestorSet[id / 32] |= 1u << (id % 32);
+      for (small_list<registry*>::iterator bidx = baseList_.begin(); bidx != baseList_.end(); ++bidx) {
+        const std::vector<unsigned int>& base = (*bidx)->ancestors();
+        if (ancestorSet.size() < base.size()) {
+          ancestorSet.resize(base.size(), 0);
+        }
+        for (size_t idx = 0; idx < base.size(); ++idx) {
+          ancestorSet[idx] |= base[idx];
+        }
+      }
+      ancestorRevision = revision_;
     }
-    lua_rawgeti(L, LUA_REGISTRYINDEX, pushedInstances[(long int) instance]);
-    return lua_gettop(L);
+    return ancestorSet;
   }
 
-  void registry::removeInstanceTable(lua_State* L, void* instance) {
-    pushedInstancesRefCount[(long int) instance] -= 1;
-    if (pushedInstancesRefCount[(long int) instance] <= 0) {
-      luaL_unref(L, LUA_REGISTRYINDEX, pushedInstances[(long int) instance]);
-      pushedInstances.erase((long int) instance);
-      pushedInstancesRefCount.erase((long int) instance);
+  const hash_map<string, member>& registry::members() {
+    if (memberRevision != revision_) {
+      memberMap.clear();
+
+      for (hash_map<string, abstract_field*>::iterator idx = fieldMap.begin(); idx != fieldMap.end(); ++idx) {
+        memberMap[idx->first].field = idx->second;
+      }
+      for (hash_map<string, small_list<abstract_method*> >::iterator idx = methodMap.begin(); idx != methodMap.end(); ++idx) {
+        member& m = memberMap[idx->first];
+        for (small_list<abstract_method*>::iterator midx = idx->second.begin(); midx != idx->second.end(); ++midx) {
+          m.methods.add(*midx);
+        }
+      }
+      for (hash_map<string, lua_CFunction>::iterator idx = directMap.begin(); idx != directMap.end(); ++idx) {
+        memberMap[idx->first].direct = idx->second;
+      }
+      for (hash_map<string, small_list<abstract_operator*> >::iterator idx = operatorMap.begin(); idx != operatorMap.end(); ++idx) {
+        member& m = memberMap[idx->first];
+        for (small_list<abstract_operator*>::iterator oidx = idx->second.begin(); oidx != idx->second.end(); ++oidx) {
+          m.operators.add(*oidx);
+        }
+      }
+
+      // bases are appended depth first, in registration order
+      for (small_list<registry*>::iterator bidx = baseList_.begin(); bidx != baseList_.end(); ++bidx) {
+        const hash_map<string, member>& baseMembers = (*bidx)->members();
+        for (hash_map<string, member>::const_iterator idx = baseMembers.begin(); idx != baseMembers.end(); ++idx) {
+          member& m = memberMap[idx->first];
+          if (m.field == NULL) {
+            m.field = idx->second.field;
+          }
+          // an inherited direct method only applies if nothing closer binds the name
+          if (m.direct == NULL && m.methods.empty()) {
+            m.direct = idx->second.direct;
+          }
+          m.methods.add(idx->second.methods);
+          m.operators.add(idx->second.operators);
+        }
+      }
+
+      memberRevision = revision_;
     }
+    return memberMap;
+  }
+
+  const member* registry::findMember(const string& name) {
+    const hash_map<string, member>& m = members();
+    hash_map<string, member>::const_iterator iter = m.find(name);
+    return iter != m.end() ? &iter->second : NULL;
   }
 
 }
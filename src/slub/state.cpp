@@ -0,0 +1,145 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "../../include/slub/state.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace slub {
+
+  allocator::allocator(size_t limit)
+  : limit(limit), chunkPos(NULL), chunkLeft(0)
+  {
+    for (int idx = 0; idx < classes; ++idx) {
+      free[idx] = NULL;
+    }
+  }
+
+  allocator::~allocator() {
+    for (size_t idx = 0; idx < chunks.size(); ++idx) {
+      std::free(chunks[idx]);
+    }
+  }
+
+  void* allocator::alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+    allocator* a = static_cast<allocator*>(ud);
+    if (ptr == NULL) {
+      osize = 0;
+    }
+    if (nsize == 0) {
+      if (ptr != NULL) {
+        a->release(ptr, osize);
+        a->stats_.bytes -= osize;
+      }
+      return NULL;
+    }
+    // Lua expects shrinking to succeed, only growth is checked
+    if (nsize > osize && a->limit != 0 && a->stats_.bytes - osize + nsize > a->limit) {
+      ++a->stats_.failures;
+      return NULL;
+    }
+
+    void* result;
+    int oclass = ptr != NULL ? sizeClass(osize) : -2;
+    int nclass = sizeClass(nsize);
+    if (oclass == nclass && nclass >= 0) {
+      result = ptr;
+    }
+    else if (oclass == -1 && nclass == -1) {
+      result = std::realloc(ptr, nsize);
+    }
+    else {
+      result = a->allocate(nsize);
+      if (result != NULL && ptr != NULL) {
+        std::memcpy(result, ptr, osize < nsize ? osize : nsize);
+        a->release(ptr, osize);
+      }
+    }
+    if (result == NULL) {
+      return NULL;
+    }
+
+    if (ptr == NULL) {
+      ++a->stats_.allocations;
+    }
+    a->stats_.bytes = a->stats_.bytes - osize + nsize;
+    if (a->stats_.bytes > a->stats_.peak) {
+      a->stats_.peak = a->stats_.bytes;
+    }
+    return result;
+  }
+
+  void* allocator::allocate(size_t size) {
+    int c = sizeClass(size);
+    if (c < 0) {
+      return std::malloc(size);
+    }
+    if (free[c] != NULL) {
+      block* b = free[c];
+      free[c] = b->next;
+      return b;
+    }
+    size_t blockSize = (size_t) (c + 1) * granularity;
+    if (chunkLeft < blockSize) {
+      // the tail of the previous chunk is dropped, it is smaller than a block
+      char* chunk = static_cast<char*>(std::malloc(chunkSize));
+      if (chunk == NULL) {
+        return NULL;
+      }
+      chunks.push_back(chunk);
+      chunkPos = chunk;
+      chunkLeft = chunkSize;
+    }
+    void* result = chunkPos;
+    chunkPos += blockSize;
+    chunkLeft -= blockSize;
+    return result;
+  }
+
+  void allocator::release(void* ptr, size_t size) {
+    int c = sizeClass(size);
+    if (c < 0) {
+      std::free(ptr);
+    }
+    else {
+      block* b = static_cast<block*>(ptr);
+      b->next = free[c];
+      free[c] = b;
+    }
+  }
+
+  lua_State* newState(size_t limit) {
+    allocator* a = new allocator(limit);
+    lua_State* L = lua_newstate(&allocator::alloc, a);
+    if (L == NULL) {
+      delete a;
+    }
+    return L;
+  }
+
+  allocator* getAllocator(lua_State* L) {
+    void* ud = NULL;
+    return lua_getallocf(L, &ud) == &allocator::alloc ? static_cast<allocator*>(ud) : NULL;
+  }
+
+  void closeState(lua_State* L) {
+    allocator* a = getAllocator(L);
+    lua_close(L);
+    delete a;
+  }
+
+}
@@ -0,0 +1,151 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+// Compares the hash map slub uses for its internal tables against std::map
+// on the lookups a binding does most: member names and type keys. The
+// script part measures registration and calls through whatever
+// SLUB_HASH_MAP_TYPE/SLUB_SMALL_LIST_TYPE are configured, build it once more
+// with -DSLUB_HASH_MAP_TYPE=std::map -DSLUB_SMALL_LIST_TYPE=std::list to
+// compare against the node based containers.
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <slub/slub.h>
+
+namespace {
+
+  typedef std::chrono::steady_clock clock_type;
+
+  double elapsed(clock_type::time_point start) {
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+  }
+
+  template<typename M, typename K>
+  double lookups(M& m, const std::vector<K>& keys, int rounds) {
+    clock_type::time_point start = clock_type::now();
+    int sum = 0;
+    for (int round = 0; round < rounds; ++round) {
+      for (size_t idx = 0; idx < keys.size(); ++idx) {
+        sum += m.find(keys[idx])->second;
+      }
+    }
+    if (sum == 42) {
+      std::cout << std::endl;
+    }
+    return elapsed(start);
+  }
+
+  template<typename K>
+  void compare(const char* what, const std::vector<K>& keys, int rounds) {
+    std::map<K, int> tree;
+    slub::flat_map<K, int> flat;
+    for (size_t idx = 0; idx < keys.size(); ++idx) {
+      tree[keys[idx]] = (int) idx;
+      flat[keys[idx]] = (int) idx;
+    }
+    double treeTime = lookups(tree, keys, rounds);
+    double flatTime = lookups(flat, keys, rounds);
+    std::printf("%-24s std::map %8.2f ms   flat_map %8.2f ms\n", what, treeTime, flatTime);
+  }
+
+  template<int n>
+  struct node {
+    node() : value(n) {}
+    int get() { return value; }
+    void set(int v) { value = v; }
+    int add(int v) { return value + v; }
+    int scale(int a, int b) { return value * a + b; }
+    bool valid() { return value >= 0; }
+    int value;
+  };
+
+  void registerNodes(lua_State*, std::integral_constant<int, 0>) {
+  }
+
+  template<int n>
+  void registerNodes(lua_State* L, std::integral_constant<int, n>) {
+    registerNodes(L, std::integral_constant<int, n - 1>());
+    char name[16];
+    std::sprintf(name, "node%d", n);
+    slub::clazz<node<n> >(L, name)
+      .constructor()
+      .field("value", &node<n>::value)
+      .method("get", &node<n>::get)
+      .method("set", &node<n>::set)
+      .method("add", &node<n>::add)
+      .method("scale", &node<n>::scale)
+      .method("valid", &node<n>::valid);
+  }
+
+  double script(lua_State* L, const char* chunk) {
+    clock_type::time_point start = clock_type::now();
+    if (luaL_dostring(L, chunk)) {
+      std::cout << lua_tostring(L, -1) << std::endl;
+    }
+    return elapsed(start);
+  }
+
+}
+
+int main(int argc, char* argv[]) {
+
+  std::vector<std::string> names;
+  const char* verbs[] = { "get", "set", "is", "has", "on" };
+  const char* nouns[] = { "Position", "Rotation", "Scale", "Visible", "Parent", "Child", "Name", "Bounds" };
+  for (size_t verb = 0; verb < sizeof(verbs) / sizeof(*verbs); ++verb) {
+    for (size_t noun = 0; noun < sizeof(nouns) / sizeof(*nouns); ++noun) {
+      names.push_back(std::string(verbs[verb]) + nouns[noun]);
+    }
+  }
+  compare("member names (40)", names, 100000);
+
+  std::vector<const void*> types;
+  std::vector<int*> storage;
+  for (int idx = 0; idx < 256; ++idx) {
+    storage.push_back(new int(idx));
+    types.push_back(storage.back());
+  }
+  compare("type keys (256)", types, 20000);
+  for (size_t idx = 0; idx < storage.size(); ++idx) {
+    delete storage[idx];
+  }
+
+  lua_State* L = slub::newState();
+  luaopen_base(L);
+
+  clock_type::time_point start = clock_type::now();
+  registerNodes(L, std::integral_constant<int, 48>());
+  std::printf("%-24s %8.2f ms\n", "register 48 classes", elapsed(start));
+
+  std::printf("%-24s %8.2f ms\n", "method calls", script(L,
+    "local nodes = {}\n"
+    "for i = 1, 48 do nodes[i] = _G['node'..i]() end\n"
+    "local sum = 0\n"
+    "for round = 1, 20000 do\n"
+    "  for i = 1, 48 do\n"
+    "    local n = nodes[i]\n"
+    "    n:set(round)\n"
+    "    sum = sum + n:get() + n:add(i) + n:scale(2, i) + n.value\n"
+    "  end\n"
+    "end"));
+
+  slub::closeState(L);
+  return 0;
+}
@@ -0,0 +1,731 @@
+/*
+Copyright (c) 2011 Timo Boll, Tony Kostanjsek
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the
+"Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish,
+distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the
+following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE
+OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+#include <boost/intrusive_ptr.hpp>
+
+#include <slub/slub.h>
+#include <slub/globals.h>
+#include <slub/table.h>
+
+#include "checks.h"
+
+using slub::string;
+
+namespace {
+
+  int failures = 0;
+
+  void expect(bool condition, const string& what) {
+    if (!condition) {
+      ++failures;
+      std::cout << "check failed: " << what << std::endl;
+    }
+  }
+
+  // the chunk reports its own failures through assert
+  void expectRun(lua_State* L, const char* chunk, const string& what) {
+    if (luaL_dostring(L, chunk)) {
+      expect(false, what + ": " + lua_tostring(L, -1));
+      lua_pop(L, 1);
+    }
+  }
+
+  lua_State* open(size_t limit = 0) {
+    lua_State* L = slub::newState(limit);
+    luaopen_base(L);
+    luaopen_string(L);
+    return L;
+  }
+
+  // dispatch
+
+  struct circle {};
+  struct square {};
+
+  struct dispatcher {
+    string pick() { return "none"; }
+    string pick(int) { return "int"; }
+    string pick(int, int) { return "int, int"; }
+    string pick(const char*) { return "string"; }
+    string pick(bool) { return "bool"; }
+    string pick(circle*) { return "circle"; }
+    string pick(square*) { return "square"; }
+    int half(int i) { return i / 2; }
+  };
+
+  // a userdata of some other library that happens to start like the
+  // header of the bound object passed in
+  int forge(lua_State* L) {
+    void* forged = lua_newuserdata(L, sizeof(slub::wrapper_base));
+    memcpy(forged, lua_touserdata(L, 1), sizeof(slub::wrapper_base));
+    static_cast<slub::wrapper_base*>(forged)->raw = NULL;
+    lua_newtable(L);
+    lua_setmetatable(L, -2);
+    return 1;
+  }
+
+  void dispatch() {
+    lua_State* L = open();
+    lua_register(L, "forge", forge);
+    slub::clazz<circle>(L, "circle").constructor();
+    slub::clazz<square>(L, "square").constructor();
+    slub::clazz<dispatcher>(L, "dispatcher").constructor()
+      .method("pick", (string(dispatcher::*)())&dispatcher::pick)
+      .method("pick", (string(dispatcher::*)(int))&dispatcher::pick)
+      .method("pick", (string(dispatcher::*)(int, int))&dispatcher::pick)
+      .method("pick", (string(dispatcher::*)(const char*))&dispatcher::pick)
+      .method("pick", (string(dispatcher::*)(bool))&dispatcher::pick)
+      .method("pick", (string(dispatcher::*)(circle*))&dispatcher::pick)
+      .method("pick", (string(dispatcher::*)(square*))&dispatcher::pick)
+      .method("half", &dispatcher::half);
+
+    expectRun(L,
+      "local d, c, s = dispatcher(), circle(), square() "
+      "for i = 1, 3 do "
+      "  assert(d:pick() == 'none') "
+      "  assert(d:pick(1) == 'int') "
+      "  assert(d:pick(1, 2) == 'int, int') "
+      "  assert(d:pick('x') == 'string') "
+      "  assert(d:pick(true) == 'bool') "
+      "  assert(d:pick(c) == 'circle') "
+      "  assert(d:pick(s) == 'square') "
+      "end "
+      "assert(not pcall(d.pick, d, {})) "
+      "assert(not pcall(d.pick, d, 1, 2, 3)) ",
+      "overloads by arity, type and class");
+
+    // foreign userdata neither share the cache entry of a class nor convert
+    expectRun(L,
+      "local d, c = dispatcher(), circle() "
+      "local forged = forge(c) "
+      "for i = 1, 3 do "
+      "  assert(d:pick(c) == 'circle') "
+      "  assert(not pcall(d.pick, d, forged)) "
+      "  assert(not pcall(d.pick, d, newproxy(true))) "
+      "end ",
+      "foreign userdata arguments");
+
+    // the call cache keys on Lua types, numeric strings still need a check
+    expectRun(L,
+      "local d = dispatcher() "
+      "for i = 1, 3 do "
+      "  assert(d:half('4') == 2) "
+      "  assert(not pcall(d.half, d, 'x')) "
+      "end ",
+      "cached overload with a string argument");
+
+    // a function assigned to the method table replaces the cached overload
+    expectRun(L,
+      "local d = dispatcher() "
+      "for i = 1, 3 do assert(d:pick(1) == 'int') end "
+      "dispatcher.pick = function(self, i) return 'script' end "
+      "assert(d:pick(1) == 'script') ",
+      "method table assignment invalidates the call cache");
+
+    slub::closeState(L);
+  }
+
+  // member lookup
+
+  struct account {
+    account() : balance(3) {}
+    int deposit(int amount) { return balance += amount; }
+    int balance;
+  };
+
+  void members() {
+    lua_State* L = open();
+    slub::clazz<account>(L, "account").constructor()
+      .field("balance", &account::balance)
+      .method("deposit", &account::deposit);
+
+    expectRun(L,
+      "local a = account() "
+      "assert(a.balance == 3) "
+      "a.balance = 4 "
+      "assert(a:deposit(2) == 6 and a.balance == 6) "
+      "assert(rawequal(a.deposit, account().deposit)) "
+      "assert(a.missing == nil) ",
+      "fields and methods through the member cache");
+
+    slub::closeState(L);
+  }
+
+  // operators
+
+  struct money {
+    money(int cents) : cents(cents) {}
+    bool operator==(const money& other) const { return cents == other.cents; }
+    bool operator<(const money& other) const { return cents < other.cents; }
+    bool operator<=(const money& other) const { return cents <= other.cents; }
+    int operator+(int other) const { return cents + other; }
+    int operator-() const { return -cents; }
+    int cents;
+  };
+
+  void operators() {
+    lua_State* L = open();
+    slub::clazz<money>(L, "money")
+      .constructor<int>()
+      .field("cents", &money::cents)
+      .eq()
+      .lt()
+      .le()
+      .add<int, int>()
+      .unm<int>();
+
+    expectRun(L,
+      "local a, b, c = money(5), money(5), money(7) "
+      "assert(a == b) "
+      "assert(a ~= c) "
+      "assert(a < c and not (c < a)) "
+      "assert(a <= b and not (c <= a)) "
+      "assert(a + 3 == 8) "
+      "assert(-c == -7) "
+      "assert(not pcall(function() return a + 'x' end)) "
+      "assert(not pcall(function() return a * 2 end)) ",
+      "operators");
+
+    slub::closeState(L);
+  }
+
+  struct amount {
+    amount(int cents) : cents(cents) {}
+    bool operator==(const amount& other) const { return cents == other.cents; }
+    int operator+(int other) const { return cents + other; }
+    int operator-() const { return -cents; }
+    int cents;
+  };
+
+  struct coin : amount {
+    coin(int cents) : amount(cents) {}
+  };
+
+  struct token : amount {
+    token(int cents) : amount(cents) {}
+  };
+
+  // base operators reach derived classes bound before and after them
+  void inheritedOperators() {
+    lua_State* L = open();
+    slub::clazz<amount> base(L, "amount");
+    base.constructor<int>().eq();
+    slub::clazz<coin>(L, "coin").extends<amount>().constructor<int>();
+    base.add<int, int>().unm<int>();
+    slub::clazz<token>(L, "token").extends<amount>().constructor<int>();
+
+    expectRun(L,
+      "local c, t = coin(5), token(7) "
+      "assert(c == coin(5) and c ~= coin(6)) "
+      "assert(t == token(7) and t ~= token(6)) "
+      "assert(c + 1 == 6 and -c == -5) "
+      "assert(t + 1 == 8 and -t == -7) ",
+      "inherited operators");
+
+    slub::closeState(L);
+  }
+
+  struct row {
+    bool operator==(const row&) const { return true; }
+    int operator[](int i) const { return i * 10; }
+    int width() const { return 3; }
+  };
+
+  // the __index operator of a class whose member cache was never or not
+  // recently built
+  void indexOperators() {
+    lua_State* L = open();
+    slub::clazz<row> rowClass(L, "row");
+    rowClass.constructor().eq().index<int, int>();
+    expectRun(L, "local r = row() assert(r[2] == 20)", "numeric index as the first access");
+    expectRun(L, "local r = row() assert(r.width == nil)", "member lookup");
+
+    // __eq rebuilds the members before the next numeric index
+    rowClass.method("width", &row::width);
+    expectRun(L,
+      "local a, b = row(), row() "
+      "assert(a == b) "
+      "assert(a[4] == 40) "
+      "assert(a:width() == 3) ",
+      "numeric index after a registration");
+
+    slub::closeState(L);
+  }
+
+  // free functions
+
+  int twice(int i) {
+    return i * 2;
+  }
+
+  string twiceString(const char* s) {
+    return string(s) + s;
+  }
+
+  void functions() {
+    lua_State* L = open();
+    slub::function(L, "twice", &twice);
+    expectRun(L,
+      "assert(twice(4) == 8) "
+      "local ok, err = pcall(twice, 'x') "
+      "assert(not ok and err:find('twice')) "
+      "old_twice = twice ",
+      "single overload");
+
+    // closures pushed before the second overload see it as well
+    slub::function(L, "twice", &twiceString);
+    expectRun(L,
+      "assert(old_twice(4) == 8) "
+      "assert(old_twice('ab') == 'abab') "
+      "assert(twice('ab') == 'abab') ",
+      "overload added later");
+
+    slub::closeState(L);
+  }
+
+  // static bindings
+
+  struct vehicle {
+    vehicle() : speed(0) {}
+    virtual ~vehicle() {}
+    int accelerate() { return speed += 10; }
+    int brake() { return speed = 0; }
+    int speed;
+  };
+
+  struct car : vehicle {
+  };
+
+  void staticMethods() {
+    lua_State* L = open();
+    slub::clazz<vehicle> vehicleClass(L, "vehicle");
+    vehicleClass.constructor()
+      .method<SLUB_STATIC(&vehicle::accelerate)>("accelerate");
+    slub::clazz<car>(L, "car").extends<vehicle>().constructor();
+
+    expectRun(L,
+      "local v, c = vehicle(), car() "
+      "assert(v:accelerate() == 10) "
+      "assert(c:accelerate() == 10 and c:accelerate() == 20) ",
+      "static binding called through a derived object");
+
+    // bound on the base after the derived class
+    vehicleClass.method<SLUB_STATIC(&vehicle::brake)>("brake");
+    expectRun(L,
+      "local c = car() "
+      "c:accelerate() "
+      "assert(c:brake() == 0) ",
+      "static binding added to the base later");
+
+    expectRun(L,
+      "local v, c = vehicle(), car() "
+      "assert(v:accelerate() == 10) "
+      "vehicle.accelerate = function(self) return -1 end "
+      "assert(v:accelerate() == -1) "
+      "car.brake = function(self) return -2 end "
+      "assert(c:brake() == -2 and v:brake() == 0) ",
+      "static binding overridden by a script");
+
+    slub::closeState(L);
+  }
+
+  // const objects
+
+  struct gadget {
+    gadget() : level(1) {}
+    int get() const { return level; }
+    void raise() { ++level; }
+    int level;
+  };
+
+  gadget sharedGadget;
+
+  gadget* mutableGadget() {
+    return &sharedGadget;
+  }
+
+  const gadget* constGadget() {
+    return &sharedGadget;
+  }
+
+  int mutate(gadget* g) {
+    g->raise();
+    return g->level;
+  }
+
+  int inspect(const gadget* g) {
+    return g->level;
+  }
+
+  void constObjects() {
+    lua_State* L = open();
+    slub::clazz<gadget>(L, "gadget").instanceCache()
+      .field("level", &gadget::level)
+      .method("get", &gadget::get)
+      .method("raise", &gadget::raise);
+    slub::function(L, "mutableGadget", &mutableGadget);
+    slub::function(L, "constGadget", &constGadget);
+    slub::function(L, "mutate", &mutate);
+    slub::function(L, "inspect", &inspect);
+
+    expectRun(L,
+      "local c, m = constGadget(), mutableGadget() "
+      "assert(rawequal(c, constGadget())) "
+      "assert(not rawequal(c, m)) "
+      "assert(rawequal(m, mutableGadget())) "
+      "assert(c:get() == 1 and c.level == 1) "
+      "assert(inspect(c) == 1) "
+      "for i = 1, 3 do "
+      "  assert(not pcall(c.raise, c)) "
+      "  assert(not pcall(mutate, c)) "
+      "  assert(not pcall(function() c.level = 5 end)) "
+      "end "
+      "m:raise() "
+      "assert(mutate(m) == 3 and c:get() == 3) ",
+      "const objects only take const access");
+
+    slub::closeState(L);
+  }
+
+  // smart pointer holders
+
+  struct counted {
+    counted() : refs(0) { ++alive; }
+    ~counted() { --alive; }
+    int refs;
+    static int alive;
+  };
+
+  int counted::alive = 0;
+
+  void intrusive_ptr_add_ref(counted* c) {
+    ++c->refs;
+  }
+
+  void intrusive_ptr_release(counted* c) {
+    if (--c->refs == 0) {
+      delete c;
+    }
+  }
+
+  boost::intrusive_ptr<counted> keptCounted;
+
+  boost::intrusive_ptr<counted> intrusiveCounted() {
+    return keptCounted;
+  }
+
+  std::unique_ptr<counted> uniqueCounted() {
+    return std::unique_ptr<counted>(new counted());
+  }
+
+  std::shared_ptr<counted> keptShared;
+
+  std::shared_ptr<counted> sharedCounted() {
+    return keptShared;
+  }
+
+  int intrusiveRefs(const boost::intrusive_ptr<counted>& c) {
+    return c->refs;
+  }
+
+  long sharedUses(const std::shared_ptr<counted>& c) {
+    return c.use_count();
+  }
+
+  void smartPointers() {
+    lua_State* L = open();
+    slub::clazz<counted>(L, "counted").instanceCache();
+    slub::function(L, "intrusiveCounted", &intrusiveCounted);
+    slub::function(L, "uniqueCounted", &uniqueCounted);
+    slub::function(L, "sharedCounted", &sharedCounted);
+    slub::function(L, "intrusiveRefs", &intrusiveRefs);
+    slub::function(L, "sharedUses", &sharedUses);
+
+    keptCounted = new counted();
+    expectRun(L,
+      "local c = intrusiveCounted() "
+      "assert(rawequal(c, intrusiveCounted())) "
+      "assert(intrusiveRefs(c) == 3) "
+      "assert(not pcall(sharedUses, c)) ",
+      "intrusive_ptr round trip");
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    expect(keptCounted->refs == 1, "collected userdata drops its intrusive reference");
+    keptCounted.reset();
+    expect(counted::alive == 0, "intrusive object deleted with its last reference");
+
+    expectRun(L,
+      "local c = uniqueCounted() "
+      "assert(not pcall(sharedUses, c)) ",
+      "unique_ptr round trip");
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    expect(counted::alive == 0, "unique_ptr object deleted on gc");
+
+    keptShared.reset(new counted());
+    expectRun(L,
+      "local c = sharedCounted() "
+      "assert(rawequal(c, sharedCounted())) "
+      "assert(sharedUses(c) == 2) ",
+      "shared_ptr round trip");
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    expect(keptShared.use_count() == 1, "collected userdata drops its shared reference");
+    keptShared.reset();
+    expect(counted::alive == 0, "shared object deleted with its last reference");
+
+    slub::closeState(L);
+  }
+
+  // references
+
+  bool anchored(lua_State* L) {
+    lua_getglobal(L, "weak");
+    lua_rawgeti(L, -1, 1);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    lua_pop(L, 1);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    lua_rawgeti(L, -1, 1);
+    bool result = !lua_isnil(L, -1);
+    lua_pop(L, 2);
+    return result;
+  }
+
+  void references() {
+    lua_State* L = open();
+    expectRun(L, "weak = setmetatable({ {} }, { __mode = 'v' })", "weak table");
+    lua_getglobal(L, "weak");
+    lua_rawgeti(L, -1, 1);
+    slub::reference* first = new slub::reference(L);
+    lua_pop(L, 1);
+
+    slub::reference* copy = new slub::reference(*first);
+    expect(copy->slot == first->slot && first->slot->count == 2, "copies share the slot");
+    slub::reference assigned;
+    assigned = *copy;
+    expect(assigned.slot == first->slot && first->slot->count == 3, "assignment shares the slot");
+    assigned = assigned;
+    expect(assigned.slot == first->slot && first->slot->count == 3, "self assignment keeps the slot");
+    expect(assigned.type() == LUA_TTABLE, "self assigned reference keeps its value");
+
+    delete first;
+    expect(anchored(L), "value anchored while copies are left");
+    delete copy;
+    expect(anchored(L), "value anchored by the last copy");
+    assigned = slub::reference();
+    expect(!anchored(L), "last copy unrefs the value");
+    expect(assigned.slot == NULL && assigned.isNil(), "assigned nil");
+
+    slub::closeState(L);
+  }
+
+  // table entries
+
+  void tableEntries() {
+    lua_State* L = open();
+    // entries give back their registry refs before the state closes
+    {
+      slub::globals g(L);
+      expectRun(L, "config = { size = 1 } function scale(v) return v * config.size end", "entry globals");
+
+      slub::table_entry size = g["config"]["size"];
+      slub::reference snapshot = size;
+      slub::table_entry moved(std::move(size));
+      expect(size.slot == NULL, "moved entry is left nil");
+      expectRun(L, "config.size = 2", "entry update");
+      expect(moved.cast<int>() == 2, "moved entry reads lazily");
+      expect(snapshot.cast<int>() == 1, "reference keeps the snapshot");
+
+      slub::table_entry copy = moved;
+      copy = 3;
+      expectRun(L, "assert(config.size == 3)", "entry writes the table");
+      expect(moved.cast<int>() == 3, "copies share the entry");
+      expect(slub::call<int, int>(g["scale"], 5) == 15, "entry called");
+      expectRun(L, "function scale(v) return -v end", "function update");
+      slub::table_entry scale = g["scale"];
+      expect(slub::call<int, int>(scale, 5) == -5, "entry calls the current function");
+
+      slub::table_entry deep = g["missing"]["inner"]["value"];
+      expect(deep.type() == LUA_TNIL && deep.isNil(), "nil intermediate table reads nil");
+      bool refused = false;
+      try {
+        deep = 1;
+      }
+      catch (const std::runtime_error&) {
+        refused = true;
+      }
+      expect(refused, "nil intermediate table refuses writes");
+      expectRun(L, "missing = { inner = { value = 4 } }", "intermediate tables");
+      expect(deep.cast<int>() == 4, "entry found once the tables exist");
+    }
+    slub::closeState(L);
+  }
+
+  void keys() {
+    lua_State* L = open();
+    {
+      slub::globals g(L);
+      expectRun(L, "config = { size = 1 } function lookup(name) return config[name] end", "key globals");
+
+      slub::key config(L, "config");
+      slub::key size(L, "size");
+      expect(size.type() == LUA_TSTRING && size.toString() == "size", "key holds its string");
+      expect(g[config][size].cast<int>() == 1, "key reads through globals");
+      slub::table_entry entry = g[config][size];
+      g["config"][size] = 2;
+      expect(entry.cast<int>() == 2, "key entry reads lazily");
+      entry = 3;
+      expectRun(L, "assert(config.size == 3)", "key entry writes the table");
+      expect(slub::call<int, slub::key>(g["lookup"], size) == 3, "key passed to a call");
+      slub::key lookup(L, "lookup");
+      expect(slub::call<int, slub::key>(g[lookup], size) == 3, "call through a key entry");
+    }
+    slub::closeState(L);
+  }
+
+  // metatables across states
+
+  struct probe {
+    int value() { return 7; }
+  };
+
+  void states() {
+    lua_State* L = open();
+    slub::clazz<probe>(L, "probe").constructor().method("value", &probe::value);
+    expectRun(L, "assert(probe():value() == 7)", "bound class in its state");
+    slub::closeState(L);
+
+    // a later state may get the registry address of the closed one, the
+    // class is not bound there and its instances get no metatable
+    for (int idx = 0; idx < 4; ++idx) {
+      L = open();
+      for (int ref = 0; ref < 16; ++ref) {
+        lua_newtable(L);
+        luaL_ref(L, LUA_REGISTRYINDEX);
+      }
+      probe p;
+      slub::converter<probe*>::push(L, &p);
+      expect(lua_getmetatable(L, -1) == 0, "no metatable of a closed state");
+      slub::closeState(L);
+    }
+  }
+
+  // value storage per state
+
+  struct cell {
+    cell() : value(5) {}
+    int value;
+  };
+
+  bool pushedInPlace(lua_State* L, const char* chunk) {
+    bool result = false;
+    if (luaL_dostring(L, chunk) == 0) {
+      result = ((slub::wrapper_base*) lua_touserdata(L, -1))->inplace;
+    }
+    lua_settop(L, 0);
+    return result;
+  }
+
+  void valueStorage() {
+    lua_State* inPlace = open();
+    lua_State* onHeap = open();
+    slub::clazz<cell>(inPlace, "cell").valueStorage().constructor().field("value", &cell::value);
+    slub::clazz<cell>(onHeap, "cell").constructor().field("value", &cell::value);
+
+    expect(pushedInPlace(inPlace, "return cell()"), "constructed in place where enabled");
+    expect(!pushedInPlace(onHeap, "return cell()"), "constructed on the heap in another state");
+    slub::converter<cell>::push(onHeap, cell());
+    expect(!((slub::wrapper_base*) lua_touserdata(onHeap, -1))->inplace, "pushed on the heap in another state");
+    lua_settop(onHeap, 0);
+    slub::converter<cell>::push(inPlace, cell());
+    expect(((slub::wrapper_base*) lua_touserdata(inPlace, -1))->inplace, "pushed in place where enabled");
+    lua_settop(inPlace, 0);
+    expectRun(onHeap, "assert(cell().value == 5)", "heap instance usable");
+    expectRun(inPlace, "assert(cell().value == 5)", "in place instance usable");
+
+    slub::closeState(inPlace);
+    slub::closeState(onHeap);
+  }
+
+  // pooled instances and state memory
+
+  struct pooled_item {
+    pooled_item(int value) : value(value) {}
+    int value;
+  };
+
+  struct pooled_owner {
+    pooled_owner(std::shared_ptr<counted> owned) : owned(owned) {}
+    std::shared_ptr<counted> owned;
+  };
+
+  void memory() {
+    lua_State* L = open();
+    slub::clazz<pooled_item, slub::pooled<pooled_item> >(L, "pooled_item")
+      .constructor<int>()
+      .field("value", &pooled_item::value);
+
+    size_t before = slub::pooled<pooled_item>::stats().allocations;
+    expectRun(L, "for i = 1, 100 do assert(pooled_item(i).value == i) end", "pooled construction");
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    expect(slub::pooled<pooled_item>::stats().allocations - before == 100, "pool counts allocations");
+    expect(slub::pooled<pooled_item>::stats().live == 0, "pool slots come back on gc");
+
+    // the converter raises the error only after the overload was picked
+    slub::clazz<counted>(L, "counted");
+    slub::function(L, "uniqueCounted", &uniqueCounted);
+    slub::clazz<pooled_owner, slub::pooled<pooled_owner> >(L, "pooled_owner")
+      .constructor<std::shared_ptr<counted> >();
+    expectRun(L, "for i = 1, 10 do assert(not pcall(pooled_owner, uniqueCounted())) end", "failed pooled construction");
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    expect(slub::pooled<pooled_owner>::stats().allocations == 0, "failed construction takes no slot");
+    expect(slub::pooled<pooled_owner>::stats().live == 0, "failed construction leaks no slot");
+    slub::closeState(L);
+
+    L = open(256 * 1024);
+    slub::allocator* a = slub::getAllocator(L);
+    expect(a != NULL && a->getLimit() == 256 * 1024, "allocator keeps its limit");
+    expect(luaL_dostring(L, "local t = {} for i = 1, 100000 do t[i] = i end") != 0, "limit refuses growth");
+    lua_settop(L, 0);
+    expect(a->stats().failures > 0, "refused allocations are counted");
+    expect(a->stats().bytes <= a->getLimit(), "usage stays below the limit");
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    expectRun(L, "local t = {} for i = 1, 100 do t[i] = i end", "state usable after a refused allocation");
+    slub::closeState(L);
+  }
+
+}
+
+int runChecks() {
+  dispatch();
+  members();
+  operators();
+  inheritedOperators();
+  indexOperators();
+  functions();
+  staticMethods();
+  constObjects();
+  smartPointers();
+  states();
+  references();
+  tableEntries();
+  keys();
+  valueStorage();
+  memory();
+  return failures;
+}
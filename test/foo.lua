@@ -25,6 +25,7 @@ f2.bar = 1337
 
 print(f.bar)
 print(f2.bar)
+print(f2:getBar())
 
 f:doStuff()
 f:doStuff(10)
@@ -71,6 +72,7 @@ print(f2 <= f)
 local f2_copy = f:getFoo(f2)
 print(tostring(f2_copy))
 print(f2 == f2_copy)
+print(rawequal(f2, f2_copy))
 f2_copy:doStuff()
 
 f2.f = f2_copy
@@ -24,6 +24,7 @@ OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <slub/table.h>
 #include <slub/debug/commandline_debugger.h>
 
+#include "checks.h"
 #include "foo.h"
 
 namespace slub {
@@ -82,6 +83,10 @@ int testing(int i, int j, int k) {
   return i+j+k;
 }
 
+int testing9(int a, int b, int c, int d, int e, int f, int g, int h, int i) {
+  return a+b+c+d+e+f+g+h+i;
+}
+
 enum enm {
   e1,
   e2
@@ -91,9 +96,36 @@ std::tr1::shared_ptr<foo> test_null_value() {
   return std::tr1::shared_ptr<foo>();
 }
 
+std::unique_ptr<foo> test_unique_value(int i) {
+  return std::unique_ptr<foo>(new foo(i));
+}
+
 struct invisible {
 };
 
+struct point {
+
+  float x;
+  float y;
+
+  point(float x, float y) : x(x), y(y) {
+  }
+
+  point add(const point& p) {
+    return point(x + p.x, y + p.y);
+  }
+
+};
+
+struct particle {
+
+  float life;
+
+  particle(float life) : life(life) {
+  }
+
+};
+
 int main (int argc, char * const argv[]) {
 
   try {
@@ -103,7 +135,7 @@ int main (int argc, char * const argv[]) {
     std::cout << typeid(b.get()).name() << std::endl;
     std::cout << typeid(*b.get()).name() << std::endl;
 
-    lua_State *L = lua_open();
+    lua_State *L = slub::newState();
 
     luaopen_base(L);
     luaopen_table(L);
@@ -143,13 +175,14 @@ int main (int argc, char * const argv[]) {
       std::cout << lua_tostring(L, -1) << std::endl;
     }
     
-    slub::clazz<foo>(L, "foo")
+    slub::clazz<foo>(L, "foo").instanceCache()
       .constructor<int>()
       .constructor<int, int>()
       .field("bar", &foo::bar)
       .method("doStuff", (void(foo::*)(void))&foo::doStuff)
       .method("doStuff", (void(foo::*)(int))&foo::doStuff)
       .method("getFoo", &foo::getFoo)
+      .method<SLUB_STATIC(&foo::getBar)>("getBar")
       .eq()
       .lt()
       .le()
@@ -197,13 +230,15 @@ int main (int argc, char * const argv[]) {
     slub::function(L, "testing2", &testing2);
     slub::function(L, "testing3", &testing3);
     slub::function(L, "testing", &testing);
+    slub::function(L, "testing9", &testing9);
 
     if (luaL_dostring(L,
                       "testing0() "
                       "testing1(1) "
                       "testing2(1, 2) "
                       "testing3(1, 2, 3) "
-                      "print(testing(1, 2, 3)) ")) {
+                      "print(testing(1, 2, 3)) "
+                      "print(testing9(1, 2, 3, 4, 5, 6, 7, 8, 9)) ")) {
       std::cout << lua_tostring(L, -1) << std::endl;
     }
 
@@ -251,6 +286,27 @@ int main (int argc, char * const argv[]) {
     slub::function(L, "test_null_value", &test_null_value);
     luaL_dostring(L, "local null_value = test_null_value() print(type(null_value))");
 
+    slub::function(L, "test_unique_value", &test_unique_value);
+    luaL_dostring(L, "local unique_value = test_unique_value(7) print(unique_value.bar)");
+
+    // point instances live inside their userdata
+    slub::clazz<point>(L, "point").valueStorage()
+      .constructor<float, float>()
+      .field("x", &point::x)
+      .field("y", &point::y)
+      .method("add", &point::add);
+
+    luaL_dostring(L, "local p = point(1, 2):add(point(3, 4)) print(p.x, p.y)");
+
+    // particles are recycled through a per type pool
+    slub::clazz<particle, slub::pooled<particle> >(L, "particle")
+      .constructor<float>()
+      .field("life", &particle::life);
+
+    luaL_dostring(L, "for i = 1, 1000 do local p = particle(i) end collectgarbage()");
+    std::cout << "particles: " << slub::pooled<particle>::stats().allocations << " allocated, "
+              << slub::pooled<particle>::stats().live << " live" << std::endl;
+
     // invisible class binding
     slub::clazz<invisible>((lua_State*) L);
 
@@ -260,7 +316,14 @@ int main (int argc, char * const argv[]) {
                      "breakpoint()");
 
     lua_gc(L, LUA_GCCOLLECT, 0);
-    lua_close(L);
+    std::cout << "peak memory above 0: " << (slub::getAllocator(L)->stats().peak > 0) << std::endl;
+    slub::closeState(L);
+
+    int failed = runChecks();
+    if (failed > 0) {
+      std::cout << failed << " checks failed" << std::endl;
+      return 1;
+    }
   }
   catch (std::exception& e) {
     std::cout << e.what() << std::endl;
@@ -89,6 +89,7 @@
       ],
 
       'sources': [
+        'checks.cpp',
         'main.cpp',
       ],
 
@@ -107,6 +108,22 @@
 
     },
 
+    {
+
+      'target_name': 'benchmark',
+      'type': 'executable',
+
+      'dependencies': [
+        '../lua_5_1_4/lua.gyp:lua',
+        '../slub.gyp:slub',
+      ],
+
+      'sources': [
+        'benchmark.cpp',
+      ],
+
+    },
+
   ],
 
 }